@@ -0,0 +1,41 @@
+#ifndef YAMLIZER_CUSTOMIZATION_H
+#define YAMLIZER_CUSTOMIZATION_H
+
+namespace yamlizer {
+
+// Specialize to deserialize the enum `E` from the names of its enumerators:
+//
+//   template <>
+//   struct yamlizer::enum_names<color> {
+//     static constexpr std::array<std::pair<std::string_view, color>, 2> value{{
+//         {"red", color::red},
+//         {"blue", color::blue},
+//     }};
+//   };
+template <class E>
+struct enum_names;
+
+// Specialize to give a std::variant alternative `T` a name. A variant selects the alternative
+// by its name when the node has the local tag `!name`, or when the discriminator key of the
+// variant has the value `name`:
+//
+//   template <>
+//   struct yamlizer::variant_name<circle> {
+//     static constexpr std::string_view value = "circle";
+//   };
+template <class T>
+struct variant_name;
+
+// Specialize to select the alternative of the variant `V` from the value of a key, which must
+// be the first key of the mapping:
+//
+//   template <>
+//   struct yamlizer::variant_discriminator<shape> {
+//     static constexpr std::string_view key = "type";
+//   };
+template <class V>
+struct variant_discriminator;
+
+} // namespace yamlizer
+
+#endif // YAMLIZER_CUSTOMIZATION_H
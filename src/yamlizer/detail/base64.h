@@ -0,0 +1,193 @@
+#ifndef YAMLIZER_DETAIL_BASE64_H
+#define YAMLIZER_DETAIL_BASE64_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace yamlizer::detail {
+
+inline constexpr std::array<std::int8_t, 256> base64_values = [] {
+  std::array<std::int8_t, 256> t{};
+  for (auto& v : t) {
+    v = -1;
+  }
+  for (int i = 0; i < 26; ++i) {
+    t['A' + i] = static_cast<std::int8_t>(i);
+    t['a' + i] = static_cast<std::int8_t>(26 + i);
+  }
+  for (int i = 0; i < 10; ++i) {
+    t['0' + i] = static_cast<std::int8_t>(52 + i);
+  }
+  t['+'] = 62;
+  t['/'] = 63;
+  return t;
+}();
+
+#if defined(__SSE2__)
+// Decodes 16 base64 characters into 12 bytes. Returns false, writing nothing, if any of them is
+// outside the alphabet (line breaks, padding, invalid characters).
+inline bool decode_base64_block(const char* in, unsigned char* out) noexcept {
+  const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+
+  // bytes >= 0x80 are negative and fall outside every range
+  const auto in_range = [v](char lo, char hi) {
+    return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(static_cast<char>(lo - 1))),
+                         _mm_cmplt_epi8(v, _mm_set1_epi8(static_cast<char>(hi + 1))));
+  };
+  const auto upper = in_range('A', 'Z');
+  const auto lower = in_range('a', 'z');
+  const auto digit = in_range('0', '9');
+  const auto plus  = _mm_cmpeq_epi8(v, _mm_set1_epi8('+'));
+  const auto slash = _mm_cmpeq_epi8(v, _mm_set1_epi8('/'));
+
+  const auto valid =
+      _mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(_mm_or_si128(digit, plus), slash));
+  if (_mm_movemask_epi8(valid) != 0xffff) {
+    return false;
+  }
+
+  // map each character to its 6-bit value by adding a per-range offset
+  const auto offset = _mm_or_si128(
+      _mm_or_si128(_mm_and_si128(upper, _mm_set1_epi8(-'A')),
+                   _mm_and_si128(lower, _mm_set1_epi8(26 - 'a'))),
+      _mm_or_si128(_mm_and_si128(digit, _mm_set1_epi8(52 - '0')),
+                   _mm_or_si128(_mm_and_si128(plus, _mm_set1_epi8(62 - '+')),
+                                _mm_and_si128(slash, _mm_set1_epi8(63 - '/')))));
+  const auto values = _mm_add_epi8(v, offset);
+
+  // [a b c d] per 32-bit lane -> [a<<6|b, c<<6|d] per 16-bit lane -> a<<18|b<<12|c<<6|d
+  const auto pairs = _mm_or_si128(
+      _mm_slli_epi16(_mm_and_si128(values, _mm_set1_epi16(0x00ff)), 6), _mm_srli_epi16(values, 8));
+  const auto words = _mm_or_si128(_mm_slli_epi32(_mm_and_si128(pairs, _mm_set1_epi32(0xffff)), 12),
+                                  _mm_srli_epi32(pairs, 16));
+
+  alignas(16) std::uint32_t w[4];
+  _mm_store_si128(reinterpret_cast<__m128i*>(w), words);
+  for (std::size_t i = 0; i < 4; ++i) {
+    out[i * 3]     = static_cast<unsigned char>(w[i] >> 16);
+    out[i * 3 + 1] = static_cast<unsigned char>(w[i] >> 8);
+    out[i * 3 + 2] = static_cast<unsigned char>(w[i]);
+  }
+  return true;
+}
+#endif
+
+// Incremental base64 decoder. Whitespace is ignored, so the line breaks of block scalars may
+// appear anywhere; padding is optional.
+class base64_decoder final {
+  std::uint32_t bits_ = 0;
+  unsigned sextets_   = 0;
+  unsigned padding_   = 0;
+
+public:
+  // Upper bound of the bytes decoded from `n` more characters.
+  static constexpr std::size_t max_decoded_size(std::size_t n) noexcept {
+    return (n + 3) / 4 * 3;
+  }
+
+  // Decodes `in` into `out`, which must have room for max_decoded_size(in.size()) bytes.
+  // Returns the end of the written bytes.
+  unsigned char* decode(std::string_view in, unsigned char* out) {
+    auto p         = in.data();
+    const auto end = p + in.size();
+    while (p < end) {
+#if defined(__SSE2__)
+      if (sextets_ == 0 && padding_ == 0) {
+        for (; end - p >= 16 && decode_base64_block(p, out); p += 16, out += 12) {
+        }
+        if (p == end) {
+          break;
+        }
+      }
+#endif
+      const auto c = *p++;
+      if (c == ' ' || c == '\n' || c == '\r' || c == '\t') {
+        continue;
+      }
+
+      if (c == '=') {
+        if (sextets_ < 2 || sextets_ + ++padding_ > 4) {
+          throw std::runtime_error("invalid base64 padding");
+        }
+        if (sextets_ + padding_ == 4) {
+          out      = flush(out);
+          sextets_ = 0;
+        }
+        continue;
+      }
+
+      const auto v = base64_values[static_cast<unsigned char>(c)];
+      if (v < 0 || padding_ != 0) {
+        throw std::runtime_error("invalid base64 character");
+      }
+      bits_ = (bits_ << 6) | static_cast<std::uint32_t>(v);
+      if (++sextets_ == 4) {
+        out      = flush(out);
+        sextets_ = 0;
+      }
+    }
+    return out;
+  }
+
+  // Writes the bytes of a trailing quantum that had no padding. A quantum that was only partly
+  // padded is an error.
+  unsigned char* finish(unsigned char* out) {
+    if (padding_ != 0 && sextets_ != 0) {
+      throw std::runtime_error("invalid base64 padding");
+    }
+    if (sextets_ != 0) {
+      if (sextets_ == 1) {
+        throw std::runtime_error("truncated base64 data");
+      }
+      out      = flush(out);
+      sextets_ = 0;
+    }
+    return out;
+  }
+
+private:
+  unsigned char* flush(unsigned char* out) noexcept {
+    const auto bits = bits_ << (6 * (4 - sextets_));
+    out[0]          = static_cast<unsigned char>(bits >> 16);
+    if (sextets_ > 2) {
+      out[1] = static_cast<unsigned char>(bits >> 8);
+    }
+    if (sextets_ > 3) {
+      out[2] = static_cast<unsigned char>(bits);
+    }
+    bits_ = 0;
+    return out + (sextets_ - 1);
+  }
+};
+
+// Decodes `in` in pieces of at most `Buffer` bytes and passes each piece to `f` as a
+// std::string_view, so that arbitrarily large data is decoded with a fixed-size buffer.
+template <std::size_t Buffer = 12288, class F>
+void decode_base64_chunks(std::string_view in, F&& f) {
+  constexpr std::size_t chars = Buffer / 3 * 4;
+  unsigned char buffer[base64_decoder::max_decoded_size(chars)];
+
+  base64_decoder d{};
+  for (std::size_t pos = 0; pos < in.size(); pos += chars) {
+    const auto end = d.decode(in.substr(pos, chars), buffer);
+    if (end != buffer) {
+      f(std::string_view{reinterpret_cast<const char*>(buffer),
+                         static_cast<std::size_t>(end - buffer)});
+    }
+  }
+  if (const auto end = d.finish(buffer); end != buffer) {
+    f(std::string_view{reinterpret_cast<const char*>(buffer),
+                       static_cast<std::size_t>(end - buffer)});
+  }
+}
+
+} // namespace yamlizer::detail
+
+#endif // YAMLIZER_DETAIL_BASE64_H
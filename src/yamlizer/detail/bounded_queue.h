@@ -0,0 +1,64 @@
+#ifndef YAMLIZER_DETAIL_BOUNDED_QUEUE_H
+#define YAMLIZER_DETAIL_BOUNDED_QUEUE_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+namespace yamlizer::detail {
+
+// Blocking single-producer/single-consumer queue. close() wakes both sides: push() fails from
+// then on, while pop() keeps draining the remaining items before reporting the end.
+template <class T>
+class bounded_queue final {
+  std::mutex mutex_;
+  std::condition_variable not_empty_;
+  std::condition_variable not_full_;
+  std::deque<T> items_;
+  std::size_t capacity_;
+  bool closed_ = false;
+
+public:
+  explicit bounded_queue(std::size_t capacity) : capacity_{std::max<std::size_t>(capacity, 1)} {}
+
+  bounded_queue(const bounded_queue&) = delete;
+  bounded_queue& operator=(const bounded_queue&) = delete;
+
+  bool push(T v) {
+    std::unique_lock<std::mutex> lock{mutex_};
+    not_full_.wait(lock, [this] { return closed_ || items_.size() < capacity_; });
+    if (closed_) {
+      return false;
+    }
+    items_.emplace_back(std::move(v));
+    not_empty_.notify_one();
+    return true;
+  }
+
+  std::optional<T> pop() {
+    std::unique_lock<std::mutex> lock{mutex_};
+    not_empty_.wait(lock, [this] { return closed_ || !items_.empty(); });
+    if (items_.empty()) {
+      return std::nullopt;
+    }
+    std::optional<T> v{std::move(items_.front())};
+    items_.pop_front();
+    not_full_.notify_one();
+    return v;
+  }
+
+  void close() {
+    const std::lock_guard<std::mutex> lock{mutex_};
+    closed_ = true;
+    not_empty_.notify_all();
+    not_full_.notify_all();
+  }
+};
+
+} // namespace yamlizer::detail
+
+#endif // YAMLIZER_DETAIL_BOUNDED_QUEUE_H
@@ -0,0 +1,40 @@
+#ifndef YAMLIZER_DETAIL_CONTEXT_H
+#define YAMLIZER_DETAIL_CONTEXT_H
+
+#include <cstddef>
+#include <utility>
+#include "yamlizer/scalar_sink.h"
+#include "yamlizer/string_pool.h"
+
+namespace yamlizer::detail {
+
+// Optional state for the deserialization running on the current thread. read_value_impl is
+// stateless, so public entry points that take extra arguments install them here for the
+// duration of the call.
+struct context {
+  string_pool* pool       = nullptr;
+  const scalar_sink* sink = nullptr;
+  std::size_t streamed    = 0; // streamed_scalar ids handed out so far
+};
+
+inline context& current_context() noexcept {
+  thread_local context c{};
+  return c;
+}
+
+class context_scope final {
+  context saved_;
+
+public:
+  explicit context_scope(const context& c) : saved_{std::exchange(current_context(), c)} {}
+  ~context_scope() {
+    current_context() = saved_;
+  }
+
+  context_scope(const context_scope&) = delete;
+  context_scope& operator=(const context_scope&) = delete;
+};
+
+} // namespace yamlizer::detail
+
+#endif // YAMLIZER_DETAIL_CONTEXT_H
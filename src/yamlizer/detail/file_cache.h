@@ -0,0 +1,234 @@
+#ifndef YAMLIZER_DETAIL_FILE_CACHE_H
+#define YAMLIZER_DETAIL_FILE_CACHE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "yamlizer/detail/perfect_hash.h"
+#include "yamlizer/detail/scan_tokens.h"
+#include "yamlizer/yaml++.h"
+
+namespace yamlizer::detail {
+
+// The tokens of one file, scanned once and shared by every document that includes it.
+struct scanned_file {
+  std::uint64_t hash;
+  std::vector<token> tokens;
+  // `!include` nodes: the index of the tag token and the canonical path of the target
+  std::vector<std::pair<std::size_t, std::filesystem::path>> includes;
+};
+
+using scanned_file_ptr = std::shared_ptr<const scanned_file>;
+
+// A non-owning view of a token of a scanned_file, with the interface read_value_impl uses.
+class token_ref final {
+  const token* token_;
+
+public:
+  explicit token_ref(const token& t) noexcept : token_{&t} {}
+
+  ::yaml_token_type_t type() const {
+    return token_->type();
+  }
+  decltype(std::declval<::yaml_token_t>().data) data() const {
+    return token_->data();
+  }
+  ::yaml_mark_t start_mark() const {
+    return token_->start_mark();
+  }
+};
+
+inline bool is_include_tag(const token& t) {
+  const auto& tag = t.data().tag;
+  return std::string_view{reinterpret_cast<const char*>(tag.handle)} == "!" &&
+         std::string_view{reinterpret_cast<const char*>(tag.suffix)} == "include";
+}
+
+inline scanned_file_ptr scan_file(const std::filesystem::path& path, std::string_view text,
+                                  std::uint64_t hash) {
+  auto file  = std::make_shared<scanned_file>();
+  file->hash = hash;
+
+  parser p{text};
+  try {
+    file->tokens = scan_tokens(p);
+  } catch (const scan_error& e) {
+    throw std::runtime_error(path.string() + ": " + e.what());
+  }
+
+  // included paths are relative to the including file
+  auto& ts = file->tokens;
+  for (std::size_t i = 0; i + 1 < ts.size(); ++i) {
+    if (ts[i].type() != ::YAML_TAG_TOKEN || !is_include_tag(ts[i])) {
+      continue;
+    }
+    if (ts[i + 1].type() != ::YAML_SCALAR_TOKEN) {
+      throw std::runtime_error("!include requires a path in " + path.string());
+    }
+    const auto& scalar = ts[i + 1].data().scalar;
+    const std::string_view target{reinterpret_cast<const char*>(scalar.value), scalar.length};
+    file->includes.emplace_back(
+        i, std::filesystem::canonical(path.parent_path() / std::filesystem::path{target}));
+  }
+  return file;
+}
+
+// Process-wide cache of scanned files keyed by canonical path. An entry is reused while the
+// modification time is unchanged; when it changes, the file is read again and rescanned only
+// if the hash of its contents differs. Concurrent loads of the same file share one scan.
+class file_cache final {
+  struct entry {
+    std::filesystem::file_time_type mtime;
+    std::shared_future<scanned_file_ptr> file;
+  };
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, entry> entries_;
+
+public:
+  static file_cache& instance() {
+    static file_cache c{};
+    return c;
+  }
+
+  // `path` must be canonical.
+  scanned_file_ptr load(const std::filesystem::path& path) {
+    const auto key   = path.string();
+    const auto mtime = std::filesystem::last_write_time(path);
+
+    std::promise<scanned_file_ptr> promise{};
+    const auto result = promise.get_future().share();
+    std::shared_future<scanned_file_ptr> previous{};
+    bool cached = false;
+    {
+      const std::lock_guard<std::mutex> lock{mutex_};
+      auto& e = entries_[key];
+      cached  = e.file.valid() && e.mtime == mtime;
+      if (cached) {
+        previous = e.file;
+      } else {
+        previous = std::exchange(e.file, result);
+        e.mtime  = mtime;
+      }
+    }
+    if (cached) {
+      return previous.get();
+    }
+
+    try {
+      std::ifstream in{path, std::ios::binary};
+      if (!in) {
+        throw std::runtime_error("failed to open " + key);
+      }
+      std::ostringstream ss{};
+      ss << in.rdbuf();
+      const auto text = std::move(ss).str();
+      const auto hash = hash_string(text, 0);
+
+      scanned_file_ptr file{};
+      if (previous.valid()) {
+        try {
+          if (auto p = previous.get(); p->hash == hash) {
+            file = std::move(p);
+          }
+        } catch (...) {
+          // the previous load failed; scan again
+        }
+      }
+      promise.set_value(file ? std::move(file) : scan_file(path, text, hash));
+    } catch (...) {
+      promise.set_exception(std::current_exception());
+      // forget the failure so that the next load retries
+      const std::lock_guard<std::mutex> lock{mutex_};
+      if (const auto it = entries_.find(key); it != entries_.end() && it->second.mtime == mtime) {
+        entries_.erase(it);
+      }
+      throw;
+    }
+    return result.get();
+  }
+};
+
+// Loads `root` and every file it includes, transitively. Each round loads the newly
+// referenced files concurrently.
+inline std::unordered_map<std::string, scanned_file_ptr>
+load_included_files(const std::filesystem::path& root) {
+  std::unordered_map<std::string, scanned_file_ptr> files{};
+  std::vector<std::filesystem::path> pending{root};
+  while (!pending.empty()) {
+    std::vector<std::future<scanned_file_ptr>> loads{};
+    for (const auto& p : pending) {
+      loads.emplace_back(std::async(std::launch::async,
+                                    [&p] { return file_cache::instance().load(p); }));
+    }
+
+    std::vector<std::filesystem::path> next{};
+    for (std::size_t i = 0; i < pending.size(); ++i) {
+      const auto file = loads[i].get();
+      files.emplace(pending[i].string(), file);
+      for (const auto& include : file->includes) {
+        const auto& target = include.second;
+        if (files.count(target.string()) == 0 &&
+            std::find(pending.begin(), pending.end(), target) == pending.end() &&
+            std::find(next.begin(), next.end(), target) == next.end()) {
+          next.push_back(target);
+        }
+      }
+    }
+    pending = std::move(next);
+  }
+  return files;
+}
+
+// Appends the tokens of `path` to `out` with each `!include` node replaced by the tokens of the
+// included file. `stack` holds the files being spliced, to detect cycles.
+inline void splice_tokens(const std::unordered_map<std::string, scanned_file_ptr>& files,
+                          const std::filesystem::path& path,
+                          std::vector<std::filesystem::path>& stack,
+                          std::vector<token_ref>& out) {
+  if (std::find(stack.begin(), stack.end(), path) != stack.end()) {
+    std::string cycle{};
+    for (const auto& p : stack) {
+      cycle += p.string() + " -> ";
+    }
+    throw std::runtime_error("include cycle: " + cycle + path.string());
+  }
+  stack.push_back(path);
+
+  const auto& file = *files.at(path.string());
+  const auto& ts   = file.tokens;
+
+  // included files contribute their root node only
+  const bool root = stack.size() == 1;
+  const auto last = root ? ts.size() : ts.size() - 1;
+  auto include    = file.includes.begin();
+  for (std::size_t i = root ? 0 : 1; i < last; ++i) {
+    if (include != file.includes.end() && include->first == i) {
+      splice_tokens(files, include->second, stack, out);
+      ++include;
+      ++i; // the path scalar
+      continue;
+    }
+    out.emplace_back(ts[i]);
+  }
+
+  stack.pop_back();
+}
+
+} // namespace yamlizer::detail
+
+#endif // YAMLIZER_DETAIL_FILE_CACHE_H
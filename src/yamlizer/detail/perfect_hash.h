@@ -0,0 +1,142 @@
+#ifndef YAMLIZER_DETAIL_PERFECT_HASH_H
+#define YAMLIZER_DETAIL_PERFECT_HASH_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+
+namespace yamlizer::detail {
+
+constexpr std::uint64_t hash_string(std::string_view s, std::uint64_t seed) noexcept {
+  // FNV-1a followed by a murmur3 finalizer so that the low bits depend on every byte
+  std::uint64_t h = 0xcbf29ce484222325ull ^ (seed * 0x9e3779b97f4a7c15ull);
+  for (const auto c : s) {
+    h ^= static_cast<unsigned char>(c);
+    h *= 0x100000001b3ull;
+  }
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdull;
+  h ^= h >> 33;
+  return h;
+}
+
+constexpr std::size_t next_power_of_two(std::size_t n) noexcept {
+  std::size_t p = 1;
+  while (p < n) {
+    p <<= 1;
+  }
+  return p;
+}
+
+// Minimal-collision lookup table over a fixed set of strings, built at compile time with the
+// hash-and-displace scheme: keys are grouped into buckets by one hash, and each bucket gets the
+// seed of a second hash that places all of its keys into free slots. A lookup is then two
+// hashes and a single string comparison.
+//
+// Construction throws on duplicate keys, which turns into a compile error when the table is a
+// constexpr variable.
+template <std::size_t N>
+class perfect_hash final {
+  static constexpr std::size_t buckets = next_power_of_two(N);
+  static constexpr std::size_t slots   = next_power_of_two(N) * 2;
+
+  std::array<std::string_view, N> keys_;
+  std::array<std::uint64_t, buckets> seeds_;
+  std::array<std::size_t, slots> slots_; // index + 1, 0 if empty
+
+  static constexpr std::size_t bucket_of(std::string_view key) noexcept {
+    return hash_string(key, 0) & (buckets - 1);
+  }
+
+  static constexpr std::size_t slot_of(std::string_view key, std::uint64_t seed) noexcept {
+    return hash_string(key, seed) & (slots - 1);
+  }
+
+  // Places the keys `members[first, last)` with `seed`, or leaves the table untouched.
+  constexpr bool place(const std::array<std::size_t, N>& members, std::size_t first,
+                       std::size_t last, std::uint64_t seed) {
+    for (auto m = first; m < last; ++m) {
+      const auto s = slot_of(keys_[members[m]], seed);
+      if (slots_[s] != 0) {
+        for (auto u = first; u < m; ++u) {
+          slots_[slot_of(keys_[members[u]], seed)] = 0;
+        }
+        return false;
+      }
+      slots_[s] = members[m] + 1;
+    }
+    return true;
+  }
+
+public:
+  static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+  constexpr explicit perfect_hash(const std::array<std::string_view, N>& keys)
+      : keys_{keys}, seeds_{}, slots_{} {
+    // group the keys by bucket: members[offsets[b], offsets[b + 1]) are the keys of bucket b
+    std::array<std::size_t, N> bucket{};
+    std::array<std::size_t, buckets + 1> offsets{};
+    for (std::size_t i = 0; i < N; ++i) {
+      bucket[i] = bucket_of(keys_[i]);
+      ++offsets[bucket[i] + 1];
+    }
+    for (std::size_t b = 0; b < buckets; ++b) {
+      offsets[b + 1] += offsets[b];
+    }
+    std::array<std::size_t, N> members{};
+    std::array<std::size_t, buckets> filled{};
+    for (std::size_t i = 0; i < N; ++i) {
+      members[offsets[bucket[i]] + filled[bucket[i]]++] = i;
+    }
+
+    // equal keys always share a bucket
+    for (std::size_t b = 0; b < buckets; ++b) {
+      for (auto m = offsets[b]; m < offsets[b + 1]; ++m) {
+        for (auto n = offsets[b]; n < m; ++n) {
+          if (keys_[members[m]] == keys_[members[n]]) {
+            throw std::logic_error("duplicate key");
+          }
+        }
+      }
+    }
+
+    // place the largest buckets first while most slots are still free
+    std::array<std::size_t, buckets> order{};
+    for (std::size_t b = 0; b < buckets; ++b) {
+      auto pos = b;
+      for (; pos > 0 && filled[order[pos - 1]] < filled[b]; --pos) {
+        order[pos] = order[pos - 1];
+      }
+      order[pos] = b;
+    }
+
+    for (const auto b : order) {
+      if (filled[b] == 0) {
+        break;
+      }
+      std::uint64_t seed = 1;
+      while (!place(members, offsets[b], offsets[b + 1], seed)) {
+        if (++seed > (1u << 20)) {
+          throw std::logic_error("failed to build a perfect hash");
+        }
+      }
+      seeds_[b] = seed;
+    }
+  }
+
+  // Returns the index of `key` in the array given to the constructor, or npos.
+  constexpr std::size_t find(std::string_view key) const noexcept {
+    if constexpr (N == 0) {
+      return npos;
+    } else {
+      const auto i = slots_[slot_of(key, seeds_[bucket_of(key)])];
+      return i != 0 && keys_[i - 1] == key ? i - 1 : npos;
+    }
+  }
+};
+
+} // namespace yamlizer::detail
+
+#endif // YAMLIZER_DETAIL_PERFECT_HASH_H
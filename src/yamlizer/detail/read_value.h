@@ -1,12 +1,20 @@
 #ifndef YAMLIZER_DETAIL_READ_VALUE_H
 #define YAMLIZER_DETAIL_READ_VALUE_H
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
 #include <iterator>
 #include <optional>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <tuple>
 #include <type_traits>
 #include <utility>
+#include <variant>
+#include <vector>
+#include <boost/container/container_fwd.hpp>
 #include <boost/convert.hpp>
 #include <boost/convert/lexical_cast.hpp>
 #include <boost/hana.hpp>
@@ -14,6 +22,12 @@
 #include <boost/hana/ext/std/pair.hpp>
 #include <boost/hana/ext/std/tuple.hpp>
 #include <boost/type_index.hpp>
+#include "yamlizer/customization.h"
+#include "yamlizer/detail/base64.h"
+#include "yamlizer/detail/context.h"
+#include "yamlizer/detail/perfect_hash.h"
+#include "yamlizer/detail/utf8.h"
+#include "yamlizer/scalar_sink.h"
 #include "yamlizer/yaml++.h"
 
 namespace yamlizer::detail {
@@ -33,27 +47,106 @@ struct has_emplace<
         std::pair<typename T::iterator, bool>>>>
     : std::true_type {};
 
+template <class T, class = void>
+struct has_try_emplace : std::false_type {};
+template <class T>
+struct has_try_emplace<T, decltype(static_cast<void>(std::declval<T>().try_emplace(
+                              std::declval<typename T::key_type>(),
+                              std::declval<typename T::mapped_type>())))> : std::true_type {};
+
+template <class T, class = void>
+struct has_reserve : std::false_type {};
+template <class T>
+struct has_reserve<T, decltype(static_cast<void>(std::declval<T>().reserve(std::size_t{})))>
+    : std::true_type {};
+
+template <class T, class = void>
+struct has_key_compare : std::false_type {};
+template <class T>
+struct has_key_compare<T, std::void_t<typename T::key_compare>> : std::true_type {};
+
+// Node-based maps store pair<const Key, T>; flat maps store pair<Key, T>.
 template <class T, class = void>
 struct is_key_value_container : std::false_type {};
 template <class T>
 struct is_key_value_container<
-    T, std::enable_if_t<std::is_same_v<
-        typename T::value_type,
-        std::pair<std::add_const_t<typename T::key_type>, typename T::mapped_type>>>>
+    T, std::enable_if_t<
+           std::is_same_v<typename T::value_type,
+                          std::pair<std::add_const_t<typename T::key_type>,
+                                    typename T::mapped_type>> ||
+           std::is_same_v<typename T::value_type,
+                          std::pair<typename T::key_type, typename T::mapped_type>>>>
     : std::true_type {};
 
+// What the entries of a mapping are read into before they become a `T`. Ordered maps collect
+// them into a contiguous buffer first, which finish_mapping() sorts once.
+template <class T, class = void>
+struct mapping_buffer {
+  using type = T;
+};
+template <class T>
+struct mapping_buffer<T, std::enable_if_t<has_key_compare<T>::value>> {
+  using type = std::vector<std::pair<typename T::key_type, typename T::mapped_type>>;
+};
+
+template <class T>
+using mapping_buffer_t = typename mapping_buffer<T>::type;
+
 template <class T>
 struct is_string : std::false_type {};
 template <>
 struct is_string<std::string> : std::true_type {};
 template <>
 struct is_string<std::wstring> : std::true_type {};
+template <>
+struct is_string<std::u16string> : std::true_type {};
+template <>
+struct is_string<std::u32string> : std::true_type {};
+template <>
+struct is_string<std::string_view> : std::true_type {};
+
+template <class T>
+struct is_wide_string : std::false_type {};
+template <>
+struct is_wide_string<std::wstring> : std::true_type {};
+template <>
+struct is_wide_string<std::u16string> : std::true_type {};
+template <>
+struct is_wide_string<std::u32string> : std::true_type {};
+
+template <class T>
+struct is_binary : std::false_type {};
+template <>
+struct is_binary<std::vector<std::byte>> : std::true_type {};
+template <>
+struct is_binary<std::vector<unsigned char>> : std::true_type {};
 
 template <class T>
 struct is_optional : std::false_type {};
 template <class T>
 struct is_optional<std::optional<T>> : std::true_type {};
 
+template <class T>
+struct is_variant : std::false_type {};
+template <class... Ts>
+struct is_variant<std::variant<Ts...>> : std::true_type {};
+
+template <class T, class = void>
+struct has_enum_names : std::false_type {};
+template <class T>
+struct has_enum_names<T, std::void_t<decltype(enum_names<T>::value)>> : std::true_type {};
+
+template <class T, class = void>
+struct has_variant_name : std::false_type {};
+template <class T>
+struct has_variant_name<T, std::void_t<decltype(variant_name<T>::value)>> : std::true_type {};
+
+template <class T, class = void>
+struct has_variant_discriminator : std::false_type {};
+template <class T>
+struct has_variant_discriminator<T, std::void_t<decltype(variant_discriminator<T>::key)>>
+    : std::true_type {};
+
 // http://en.cppreference.com/w/cpp/types/remove_cvref
 template <class T>
 using remove_cvref_t = std::remove_cv_t<std::remove_reference_t<T>>;
@@ -75,24 +168,503 @@ bool check_token_type(::yaml_token_type_t type, Iterator begin, Iterator end) {
   return begin->type() == type;
 }
 
+template <class Token>
+std::string_view scalar_value(const Token& t) {
+  const auto& scalar = t.data().scalar;
+  return {reinterpret_cast<const char*>(scalar.value), scalar.length};
+}
+
+template <class T, class Token>
+T convert_scalar(const Token& t) {
+  if constexpr (std::is_same_v<T, std::string>) {
+    // build the string straight from the scalar bytes
+    return T{scalar_value(t)};
+  } else if constexpr (std::is_same_v<T, std::string_view>) {
+    if (auto pool = current_context().pool) {
+      return pool->intern(scalar_value(t));
+    } else {
+      throw std::runtime_error("std::string_view requires a yamlizer::string_pool");
+    }
+  } else if constexpr (is_wide_string<T>::value) {
+    return transcode_utf8<typename T::value_type>(scalar_value(t));
+  } else {
+    boost::cnv::lexical_cast cnv{};
+    if (auto v = boost::convert<T>(t.data().scalar.value, cnv)) {
+      return v.value();
+    } else {
+      throw std::runtime_error("failed to convert value to "s +
+                               boost::typeindex::type_id<T>().pretty_name());
+    }
+  }
+}
+
+// Base64-decodes a `!!binary` scalar into a byte vector sized for the worst case, then shrunk.
+template <class T, class Token>
+T convert_binary(const Token& t) {
+  const auto s = scalar_value(t);
+
+  T result(base64_decoder::max_decoded_size(s.size()));
+  const auto first = reinterpret_cast<unsigned char*>(result.data());
+
+  base64_decoder d{};
+  const auto last = d.finish(d.decode(s, first));
+  result.resize(static_cast<std::size_t>(last - first));
+  return result;
+}
+
+// Passes the bytes of a scalar to the sink installed by from_yaml(). Plain scalars are passed
+// straight from the token; `!!binary` ones are decoded through a fixed-size buffer.
+template <class Token>
+streamed_scalar stream_scalar(const Token& t, bool binary) {
+  auto& c = current_context();
+  if (!c.sink) {
+    throw std::runtime_error("yamlizer::streamed_scalar requires a yamlizer::scalar_sink");
+  }
+
+  streamed_scalar result{c.streamed++, 0};
+  const auto& sink = *c.sink;
+  const auto write = [&result, &sink](std::string_view chunk) {
+    sink(result.id, chunk);
+    result.size += chunk.size();
+  };
+  if (binary) {
+    decode_base64_chunks(scalar_value(t), write);
+  } else {
+    write(scalar_value(t));
+  }
+  return result;
+}
+
+template <class Token>
+bool is_binary_tag(const Token& t) {
+  const auto& tag = t.data().tag;
+  const std::string_view handle{reinterpret_cast<const char*>(tag.handle)};
+  const std::string_view suffix{reinterpret_cast<const char*>(tag.suffix)};
+  return (handle == "!!" && suffix == "binary") ||
+         (handle.empty() && suffix == "tag:yaml.org,2002:binary");
+}
+
+// Skips the tag of a binary node. Returns whether it was `!!binary`; other tags are rejected.
+template <class Iterator>
+std::tuple<bool, Iterator> read_binary_tag(Iterator begin, Iterator end) {
+  if (!check_token_type(::YAML_TAG_TOKEN, begin, end)) {
+    return std::make_tuple(false, begin);
+  }
+  if (!is_binary_tag(*begin)) {
+    const auto& tag = begin->data().tag;
+    throw std::runtime_error("unexpected tag: "s + reinterpret_cast<const char*>(tag.handle) +
+                             reinterpret_cast<const char*>(tag.suffix));
+  }
+  return std::make_tuple(true, std::next(begin));
+}
+
+// Builds an ordered map from the entries of a mapping in one pass: flat maps from the sorted
+// range, and node-based maps by inserting at the end. An unordered buffer is the result itself.
+template <class T, class Buffer>
+T finish_mapping(Buffer&& entries) {
+  if constexpr (std::is_same_v<remove_cvref_t<Buffer>, T>) {
+    return std::forward<Buffer>(entries);
+  } else {
+    const typename T::key_compare comp{};
+    std::sort(entries.begin(), entries.end(),
+              [&comp](const auto& a, const auto& b) { return comp(a.first, b.first); });
+    const auto duplicate = std::adjacent_find(
+        entries.begin(), entries.end(),
+        [&comp](const auto& a, const auto& b) { return !comp(a.first, b.first); });
+    if (duplicate != entries.end()) {
+      throw std::runtime_error("failed to insert an object");
+    }
+
+    const auto first = std::make_move_iterator(entries.begin());
+    const auto last  = std::make_move_iterator(entries.end());
+    if constexpr (std::is_constructible_v<T, boost::container::ordered_unique_range_t,
+                                          decltype(first), decltype(last)>) {
+      return T(boost::container::ordered_unique_range, first, last);
+    } else {
+      T result{};
+      for (auto it = first; it != last; ++it) {
+        result.emplace_hint(result.end(), *it);
+      }
+      return result;
+    }
+  }
+}
+
+template <class Iterator>
+struct is_random_access_iterator
+    : std::is_base_of<std::random_access_iterator_tag,
+                      typename std::iterator_traits<Iterator>::iterator_category> {};
+
+// Returns the number of entries of the mapping whose first entry is at `begin`. Used as a
+// size hint only, so nested nodes are skipped without being inspected. Only worth it over
+// random-access iterators: over a token_stream_iterator it would wait for the whole mapping to
+// be scanned before the first entry could be read.
+template <class Iterator>
+std::size_t count_mapping_entries(Iterator begin, Iterator end) {
+  std::size_t entries = 0;
+  std::size_t depth   = 0;
+  for (auto it = begin; it != end; ++it) {
+    switch (it->type()) {
+      case ::YAML_BLOCK_SEQUENCE_START_TOKEN:
+      case ::YAML_BLOCK_MAPPING_START_TOKEN:
+      case ::YAML_FLOW_SEQUENCE_START_TOKEN:
+      case ::YAML_FLOW_MAPPING_START_TOKEN:
+        ++depth;
+        break;
+
+      case ::YAML_BLOCK_END_TOKEN:
+      case ::YAML_FLOW_SEQUENCE_END_TOKEN:
+      case ::YAML_FLOW_MAPPING_END_TOKEN:
+        if (depth == 0) {
+          return entries;
+        }
+        --depth;
+        break;
+
+      case ::YAML_KEY_TOKEN:
+        if (depth == 0) {
+          ++entries;
+        }
+        break;
+
+      default:
+        break;
+    }
+  }
+  return entries;
+}
+
+// Returns the iterator past the node at `begin` without converting anything. Tokens that cannot
+// start a node denote an empty node, which is skipped by returning `begin` itself.
+template <class Iterator>
+Iterator skip_value(Iterator begin, Iterator end) {
+  auto it = begin;
+  while (check_token_type(::YAML_TAG_TOKEN, it, end) ||
+         check_token_type(::YAML_ANCHOR_TOKEN, it, end)) {
+    ++it;
+  }
+
+  switch (it->type()) {
+    case ::YAML_SCALAR_TOKEN:
+    case ::YAML_ALIAS_TOKEN:
+      return std::next(it);
+
+    case ::YAML_BLOCK_SEQUENCE_START_TOKEN:
+    case ::YAML_BLOCK_MAPPING_START_TOKEN:
+    case ::YAML_FLOW_SEQUENCE_START_TOKEN:
+    case ::YAML_FLOW_MAPPING_START_TOKEN:
+      for (std::size_t depth = 0;;) {
+        if (it >= end) {
+          throw std::runtime_error("iterator reached the end");
+        }
+        switch (it->type()) {
+          case ::YAML_BLOCK_SEQUENCE_START_TOKEN:
+          case ::YAML_BLOCK_MAPPING_START_TOKEN:
+          case ::YAML_FLOW_SEQUENCE_START_TOKEN:
+          case ::YAML_FLOW_MAPPING_START_TOKEN:
+            ++depth;
+            break;
+
+          case ::YAML_BLOCK_END_TOKEN:
+          case ::YAML_FLOW_SEQUENCE_END_TOKEN:
+          case ::YAML_FLOW_MAPPING_END_TOKEN:
+            if (--depth == 0) {
+              return std::next(it);
+            }
+            break;
+
+          default:
+            break;
+        }
+        ++it;
+      }
+
+    default:
+      return it;
+  }
+}
+
+template <class E, std::size_t... Is>
+constexpr auto make_enum_hash(std::index_sequence<Is...>) {
+  return perfect_hash<sizeof...(Is)>{{{std::get<0>(enum_names<E>::value[Is])...}}};
+}
+
+template <class E>
+inline constexpr auto enum_hash =
+    make_enum_hash<E>(std::make_index_sequence<std::size(enum_names<E>::value)>{});
+
+template <class T, class Token>
+T convert_enum(const Token& t) {
+  static_assert(has_enum_names<T>::value, "yamlizer::enum_names<T> is not specialized");
+  const auto i = enum_hash<T>.find(scalar_value(t));
+  if (i == decltype(enum_hash<T>)::npos) {
+    throw std::runtime_error("failed to convert value to "s +
+                             boost::typeindex::type_id<T>().pretty_name());
+  }
+  return std::get<1>(enum_names<T>::value[i]);
+}
+
+enum class node_shape { scalar, sequence, mapping, none };
+
+template <class T>
+constexpr node_shape shape_of() noexcept {
+  if constexpr (std::is_arithmetic_v<T> || is_string<T>::value || std::is_enum_v<T> ||
+                is_binary<T>::value || std::is_same_v<T, streamed_scalar>) {
+    return node_shape::scalar;
+  } else if constexpr (boost::hana::Struct<T>::value || boost::hana::Product<T>::value ||
+                       is_key_value_container<T>::value) {
+    return node_shape::mapping;
+  } else if constexpr (boost::hana::Foldable<T>::value || has_emplace_back<T>::value) {
+    return node_shape::sequence;
+  } else {
+    return node_shape::none;
+  }
+}
+
+inline node_shape token_shape(::yaml_token_type_t type) noexcept {
+  switch (type) {
+    case ::YAML_SCALAR_TOKEN:
+      return node_shape::scalar;
+    case ::YAML_BLOCK_SEQUENCE_START_TOKEN:
+    case ::YAML_FLOW_SEQUENCE_START_TOKEN:
+      return node_shape::sequence;
+    case ::YAML_BLOCK_MAPPING_START_TOKEN:
+    case ::YAML_FLOW_MAPPING_START_TOKEN:
+      return node_shape::mapping;
+    default:
+      return node_shape::none;
+  }
+}
+
+template <class T>
+constexpr std::string_view variant_name_of() noexcept {
+  if constexpr (has_variant_name<T>::value) {
+    return variant_name<T>::value;
+  } else {
+    return {};
+  }
+}
+
+// Where the alternative chosen by select_alternative() starts: at a node, or at the entries
+// that follow the discriminator of a block or flow mapping.
+enum class alternative_position { node, block_entries, flow_entries };
+
+// Compile-time dispatch tables for a std::variant: the alternative for each node shape, and a
+// perfect hash from the names of the alternatives to their indices.
+template <class V>
+struct variant_table;
+template <class... Ts>
+struct variant_table<std::variant<Ts...>> {
+  static constexpr std::size_t npos      = static_cast<std::size_t>(-1);
+  static constexpr std::size_t ambiguous = npos - 1;
+
+  static constexpr std::array<std::size_t, 3> by_shape = [] {
+    constexpr std::array<node_shape, sizeof...(Ts)> shapes{shape_of<Ts>()...};
+    std::array<std::size_t, 3> a{npos, npos, npos};
+    for (std::size_t i = 0; i < shapes.size(); ++i) {
+      if (shapes[i] != node_shape::none) {
+        auto& slot = a[static_cast<std::size_t>(shapes[i])];
+        slot       = slot == npos ? i : ambiguous;
+      }
+    }
+    return a;
+  }();
+
+  static constexpr std::size_t named = (std::size_t{has_variant_name<Ts>::value} + ... + 0);
+
+  // indices of the named alternatives, in the order of `names`
+  static constexpr std::array<std::size_t, named> named_indices = [] {
+    constexpr std::array<std::string_view, sizeof...(Ts)> all{variant_name_of<Ts>()...};
+    std::array<std::size_t, named> a{};
+    for (std::size_t i = 0, n = 0; i < all.size(); ++i) {
+      if (!all[i].empty()) {
+        a[n++] = i;
+      }
+    }
+    return a;
+  }();
+
+  static constexpr perfect_hash<named> names = [] {
+    constexpr std::array<std::string_view, sizeof...(Ts)> all{variant_name_of<Ts>()...};
+    std::array<std::string_view, named> a{};
+    for (std::size_t n = 0; n < named; ++n) {
+      a[n] = all[named_indices[n]];
+    }
+    return perfect_hash<named>{a};
+  }();
+
+  static constexpr std::size_t find(std::string_view name) noexcept {
+    const auto i = names.find(name);
+    return i == decltype(names)::npos ? npos : named_indices[i];
+  }
+};
+
+// Chooses the alternative of the variant `V` for the node at `begin` without reading it: by a
+// local tag (`!name`), then by the discriminator key if `V` has one, then by the shape of the
+// node.
+template <class V, class Iterator>
+std::tuple<std::size_t, Iterator, alternative_position> select_alternative(Iterator begin,
+                                                                           Iterator end) {
+  using table = variant_table<V>;
+
+  if (check_token_type(::YAML_TAG_TOKEN, begin, end)) {
+    const auto& tag = begin->data().tag;
+    if (std::string_view{reinterpret_cast<const char*>(tag.handle)} == "!") {
+      const std::string_view name{reinterpret_cast<const char*>(tag.suffix)};
+      const auto i = table::find(name);
+      if (i == table::npos) {
+        throw std::runtime_error("unknown tag: !"s + std::string{name});
+      }
+      return std::make_tuple(i, std::next(begin), alternative_position::node);
+    }
+    // other tags do not select an alternative
+    begin = std::next(begin);
+  }
+
+  if constexpr (has_variant_discriminator<V>::value) {
+    const bool block = check_token_type(::YAML_BLOCK_MAPPING_START_TOKEN, begin, end);
+    if (block || check_token_type(::YAML_FLOW_MAPPING_START_TOKEN, begin, end)) {
+      constexpr std::string_view key = variant_discriminator<V>::key;
+
+      const auto k = std::next(begin, 2);
+      if (!check_token_type(::YAML_KEY_TOKEN, std::next(begin), end) ||
+          !check_token_type(::YAML_SCALAR_TOKEN, k, end) || scalar_value(*k) != key) {
+        throw std::runtime_error("discriminator key not found: "s + std::string{key});
+      }
+      if (!check_token_type(::YAML_VALUE_TOKEN, std::next(k), end)) {
+        throw std::runtime_error("token type != YAML_VALUE_TOKEN");
+      }
+      const auto v = std::next(k, 2);
+      if (!check_token_type(::YAML_SCALAR_TOKEN, v, end)) {
+        throw std::runtime_error("token type != YAML_SCALAR_TOKEN");
+      }
+      const auto i = table::find(scalar_value(*v));
+      if (i == table::npos) {
+        throw std::runtime_error("unknown "s + std::string{key} + ": "s +
+                                 std::string{scalar_value(*v)});
+      }
+
+      auto it = std::next(v);
+      if (block) {
+        return std::make_tuple(i, it, alternative_position::block_entries);
+      }
+      if (check_token_type(::YAML_FLOW_ENTRY_TOKEN, it, end)) {
+        it = std::next(it);
+      }
+      return std::make_tuple(i, it, alternative_position::flow_entries);
+    }
+  }
+
+  if (begin >= end) {
+    throw std::runtime_error("iterator reached the end");
+  }
+  const auto shape = token_shape(begin->type());
+  const auto i = shape == node_shape::none ? table::npos
+                                           : table::by_shape[static_cast<std::size_t>(shape)];
+  if (i == table::ambiguous) {
+    throw std::runtime_error("ambiguous alternative of "s +
+                             boost::typeindex::type_id<V>().pretty_name() +
+                             "; add a tag to the node"s);
+  } else if (i == table::npos) {
+    throw std::runtime_error("no alternative of "s +
+                             boost::typeindex::type_id<V>().pretty_name() + " for "s +
+                             std::string{token_type_to_string(begin->type())});
+  }
+  return std::make_tuple(i, begin, alternative_position::node);
+}
+
 struct read_value_impl {
   template <class T, class Iterator>
   static auto apply(Iterator begin, Iterator end)
       -> std::enable_if_t<std::is_arithmetic_v<T> || is_string<T>::value,
                           std::tuple<T, Iterator>> {
     if (check_token_type(::YAML_SCALAR_TOKEN, begin, end)) {
-      boost::cnv::lexical_cast cnv{};
-      if (auto v = boost::convert<T>(begin->data().scalar.value, cnv)) {
-        return std::make_tuple(v.value(), std::next(begin));
-      } else {
-        throw std::runtime_error("failed to convert value to "s +
-                                 boost::typeindex::type_id<T>().pretty_name());
+      return std::make_tuple(convert_scalar<T>(*begin), std::next(begin));
+    } else {
+      throw std::runtime_error("token type != YAML_SCALAR_TOKEN");
+    }
+  }
+
+  // Byte vectors are read from base64 scalars, optionally tagged `!!binary`. Untagged
+  // sequences of std::vector<unsigned char> are still read element by element.
+  template <class T, class Iterator>
+  static auto apply(Iterator begin, Iterator end)
+      -> std::enable_if_t<is_binary<T>::value, std::tuple<T, Iterator>> {
+    const auto [tagged, it] = read_binary_tag(begin, end);
+    if (check_token_type(::YAML_SCALAR_TOKEN, it, end)) {
+      return std::make_tuple(convert_binary<T>(*it), std::next(it));
+    }
+
+    if constexpr (std::is_same_v<typename T::value_type, unsigned char>) {
+      if (!tagged && check_token_type(::YAML_BLOCK_SEQUENCE_START_TOKEN, it, end)) {
+        return read_value_impl::read_block_sequence<T>(std::next(it), end);
+      } else if (!tagged && check_token_type(::YAML_FLOW_SEQUENCE_START_TOKEN, it, end)) {
+        return read_value_impl::read_flow_sequence<T>(std::next(it), end);
       }
+    }
+    throw std::runtime_error("token type != YAML_SCALAR_TOKEN");
+  }
+
+  template <class T, class Iterator>
+  static auto apply(Iterator begin, Iterator end)
+      -> std::enable_if_t<std::is_same_v<T, streamed_scalar>, std::tuple<T, Iterator>> {
+    const auto [binary, it] = read_binary_tag(begin, end);
+    if (check_token_type(::YAML_SCALAR_TOKEN, it, end)) {
+      return std::make_tuple(stream_scalar(*it, binary), std::next(it));
     } else {
       throw std::runtime_error("token type != YAML_SCALAR_TOKEN");
     }
   }
 
+  template <class T, class Iterator>
+  static auto apply(Iterator begin, Iterator end)
+      -> std::enable_if_t<std::is_enum_v<T>, std::tuple<T, Iterator>> {
+    if (check_token_type(::YAML_SCALAR_TOKEN, begin, end)) {
+      return std::make_tuple(convert_enum<T>(*begin), std::next(begin));
+    } else {
+      throw std::runtime_error("token type != YAML_SCALAR_TOKEN");
+    }
+  }
+
+  template <class T, class Iterator>
+  static auto apply(Iterator begin, Iterator end)
+      -> std::enable_if_t<is_variant<T>::value, std::tuple<T, Iterator>> {
+    const auto [index, it, position] = select_alternative<T>(begin, end);
+    return read_value_impl::read_alternative<T>(
+        index, it, end, position, std::make_index_sequence<std::variant_size_v<T>>{});
+  }
+
+  template <class T, class Iterator, std::size_t... Is>
+  static std::tuple<T, Iterator> read_alternative(std::size_t index, Iterator begin,
+                                                  Iterator end, alternative_position position,
+                                                  std::index_sequence<Is...>) {
+    using reader = std::tuple<T, Iterator> (*)(Iterator, Iterator, alternative_position);
+    static constexpr reader readers[] = {&read_value_impl::read_alternative<T, Is, Iterator>...};
+    return readers[index](begin, end, position);
+  }
+
+  template <class T, std::size_t I, class Iterator>
+  static std::tuple<T, Iterator> read_alternative(Iterator begin, Iterator end,
+                                                  alternative_position position) {
+    using alternative_type = std::variant_alternative_t<I, T>;
+
+    auto r = [&] {
+      if constexpr (shape_of<alternative_type>() == node_shape::mapping &&
+                    !boost::hana::Product<alternative_type>::value) {
+        if (position == alternative_position::block_entries) {
+          return read_value_impl::read_block_mapping<alternative_type>(begin, end);
+        } else if (position == alternative_position::flow_entries) {
+          return read_value_impl::read_flow_mapping<alternative_type>(begin, end);
+        }
+      } else if (position != alternative_position::node) {
+        throw std::runtime_error("alternative selected by a discriminator must be a mapping");
+      }
+      return read_value_impl::apply<alternative_type>(begin, end);
+    }();
+
+    return std::make_tuple(T{std::in_place_index<I>, std::move(std::get<0>(r))}, std::get<1>(r));
+  }
+
   template <class T, class Iterator>
   static auto apply(Iterator begin, Iterator end)
       -> std::enable_if_t<boost::hana::Product<T>::value, std::tuple<T, Iterator>> {
@@ -102,7 +674,7 @@ struct read_value_impl {
           "token type != YAML_BLOCK_MAPPING_START_TOKEN || YAML_FLOW_MAPPING_START_TOKEN");
     }
 
-    const auto r = read_value_impl::read_key_value<T>(std::next(begin), end);
+    auto r = read_value_impl::read_key_value<T>(std::next(begin), end);
 
     if (!(check_token_type(::YAML_BLOCK_END_TOKEN, std::get<1>(r), end) ||
           check_token_type(::YAML_FLOW_MAPPING_END_TOKEN, std::get<1>(r), end))) {
@@ -110,7 +682,7 @@ struct read_value_impl {
           "token type != YAML_BLOCK_END_TOKEN || YAML_FLOW_MAPPING_END_TOKEN");
     }
 
-    return std::make_tuple(std::get<0>(r), std::next(std::get<1>(r)));
+    return std::make_tuple(std::move(std::get<0>(r)), std::next(std::get<1>(r)));
   }
 
   template <class T, class Iterator>
@@ -148,19 +720,17 @@ struct read_value_impl {
   static auto read_block_mapping(Iterator begin, Iterator end)
       -> std::enable_if_t<has_emplace<T>::value && is_key_value_container<T>::value,
                           std::tuple<T, Iterator>> {
-    T result{};
+    mapping_buffer_t<T> result{};
+    if constexpr (has_reserve<decltype(result)>::value &&
+                  is_random_access_iterator<Iterator>::value) {
+      result.reserve(count_mapping_entries(begin, end));
+    }
     for (auto it = begin;;) {
       if (check_token_type(::YAML_BLOCK_END_TOKEN, it, end)) {
-        return std::make_tuple(result, std::next(it));
-      }
-
-      const auto r = read_value_impl::read_key_value<typename T::value_type>(it, end);
-
-      if (!std::get<1>(result.emplace(std::get<0>(r)))) {
-        throw std::runtime_error("failed to insert an object");
+        return std::make_tuple(finish_mapping<T>(std::move(result)), std::next(it));
       }
 
-      it = std::get<1>(r);
+      it = read_value_impl::read_entry(result, it, end);
     }
   }
 
@@ -168,24 +738,57 @@ struct read_value_impl {
   static auto read_flow_mapping(Iterator begin, Iterator end)
       -> std::enable_if_t<has_emplace<T>::value && is_key_value_container<T>::value,
                           std::tuple<T, Iterator>> {
-    T result{};
+    mapping_buffer_t<T> result{};
+    if constexpr (has_reserve<decltype(result)>::value &&
+                  is_random_access_iterator<Iterator>::value) {
+      result.reserve(count_mapping_entries(begin, end));
+    }
     for (auto it = begin;;) {
       if (check_token_type(::YAML_FLOW_MAPPING_END_TOKEN, it, end)) {
-        return std::make_tuple(result, std::next(it));
+        return std::make_tuple(finish_mapping<T>(std::move(result)), std::next(it));
       }
 
       if (check_token_type(::YAML_FLOW_ENTRY_TOKEN, it, end)) {
         it = std::next(it);
       }
 
-      const auto r = read_value_impl::read_key_value<typename T::value_type>(it, end);
+      it = read_value_impl::read_entry(result, it, end);
+    }
+  }
 
-      if (!std::get<1>(result.emplace(std::get<0>(r)))) {
-        throw std::runtime_error("failed to insert an object");
-      }
+  // Reads a key/value pair and inserts it into `result` without going through a temporary
+  // value_type, so that the key is only constructed once. `result` is a mapping_buffer_t.
+  template <class T, class Iterator>
+  static Iterator read_entry(T& result, Iterator begin, Iterator end) {
+    if (!check_token_type(::YAML_KEY_TOKEN, begin, end)) {
+      throw std::runtime_error("token type != YAML_KEY_TOKEN");
+    }
+    using key_type    = remove_cvref_t<typename T::value_type::first_type>;
+    using mapped_type = typename T::value_type::second_type;
 
-      it = std::get<1>(r);
+    auto key = read_value_impl::apply<key_type>(std::next(begin), end);
+
+    if (!check_token_type(::YAML_VALUE_TOKEN, std::get<1>(key), end)) {
+      throw std::runtime_error("token type != YAML_VALUE_TOKEN");
+    }
+    auto value = read_value_impl::apply<mapped_type>(std::next(std::get<1>(key)), end);
+
+    bool inserted = true;
+    if constexpr (has_emplace_back<T>::value) {
+      // a mapping_buffer; duplicates are found by finish_mapping()
+      result.emplace_back(std::move(std::get<0>(key)), std::move(std::get<0>(value)));
+    } else if constexpr (has_try_emplace<T>::value) {
+      inserted = std::get<1>(
+          result.try_emplace(std::move(std::get<0>(key)), std::move(std::get<0>(value))));
+    } else {
+      inserted = std::get<1>(
+          result.emplace(std::move(std::get<0>(key)), std::move(std::get<0>(value))));
+    }
+    if (!inserted) {
+      throw std::runtime_error("failed to insert an object");
     }
+
+    return std::get<1>(value);
   }
 
   template <class T, class Iterator>
@@ -214,20 +817,19 @@ struct read_value_impl {
       -> std::enable_if_t<boost::hana::Foldable<T>::value && boost::hana::Struct<T>::value,
                           std::tuple<T, Iterator>> {
     const auto keys = boost::hana::keys(T{});
-    const auto r1   = boost::hana::fold_left(
+    auto r1         = boost::hana::fold_left(
         keys, std::forward_as_tuple(T{}, begin), [end](auto acc, auto key) {
           auto& acc0       = std::get<0>(acc);
           using value_type = remove_cvref_t<decltype(boost::hana::at_key(acc0, key))>;
-          const auto r =
-              read_value_impl::read_struct_member<value_type>(std::get<1>(acc), end, key);
-          boost::hana::at_key(acc0, key) = std::get<0>(r);
-          return std::make_tuple(acc0, std::get<1>(r));
+          auto r = read_value_impl::read_struct_member<value_type>(std::get<1>(acc), end, key);
+          boost::hana::at_key(acc0, key) = std::move(std::get<0>(r));
+          return std::make_tuple(std::move(acc0), std::get<1>(r));
         });
 
     if (!check_token_type(::YAML_BLOCK_END_TOKEN, std::get<1>(r1), end)) {
       throw std::runtime_error("token type != YAML_BLOCK_END_TOKEN");
     }
-    return std::make_tuple(std::get<0>(r1), std::next(std::get<1>(r1)));
+    return std::make_tuple(std::move(std::get<0>(r1)), std::next(std::get<1>(r1)));
   }
 
   template <class T, class Iterator>
@@ -240,10 +842,9 @@ struct read_value_impl {
       return [end, key](auto acc) {
         auto& obj        = std::get<0>(acc);
         using value_type = remove_cvref_t<decltype(boost::hana::at_key(obj, key))>;
-        const auto r =
-            read_value_impl::read_struct_member<value_type>(std::get<1>(acc), end, key);
-        boost::hana::at_key(obj, key) = std::get<0>(r);
-        return std::make_tuple(obj, std::get<1>(r));
+        auto r = read_value_impl::read_struct_member<value_type>(std::get<1>(acc), end, key);
+        boost::hana::at_key(obj, key) = std::move(std::get<0>(r));
+        return std::make_tuple(std::move(obj), std::get<1>(r));
       };
     });
 
@@ -252,10 +853,10 @@ struct read_value_impl {
       if (!check_token_type(::YAML_FLOW_ENTRY_TOKEN, begin, end)) {
         throw std::runtime_error("token type != YAML_FLOW_ENTRY_TOKEN");
       }
-      return std::make_tuple(obj, std::next(begin));
+      return std::make_tuple(std::move(obj), std::next(begin));
     });
 
-    const auto r = boost::hana::fold_left(
+    auto r = boost::hana::fold_left(
         fs2, std::forward_as_tuple(T{}, begin),
         [end](auto&& acc, auto f) { return f(std::forward<decltype(acc)>(acc)); });
 
@@ -263,7 +864,7 @@ struct read_value_impl {
       throw std::runtime_error("token type != YAML_FLOW_MAPPING_END_TOKEN");
     }
 
-    return std::make_tuple(std::get<0>(r), std::next(std::get<1>(r)));
+    return std::make_tuple(std::move(std::get<0>(r)), std::next(std::get<1>(r)));
   }
 
   template <class T, class Iterator>
@@ -290,7 +891,8 @@ struct read_value_impl {
 
   template <class T, class Iterator>
   static auto apply(Iterator begin, Iterator end)
-      -> std::enable_if_t<has_emplace_back<T>::value && !is_string<T>::value,
+      -> std::enable_if_t<has_emplace_back<T>::value && !is_string<T>::value &&
+                              !is_binary<T>::value,
                           std::tuple<T, Iterator>> {
     if (begin >= end) {
       throw std::runtime_error("iterator reached the end");
@@ -316,11 +918,11 @@ struct read_value_impl {
 
     const auto fs1 = boost::hana::transform(keys, [end](auto&& key) {
       return [end, key](auto acc) {
-        auto obj                  = std::get<0>(acc);
+        auto& obj                 = std::get<0>(acc);
         using value_type          = remove_cvref_t<decltype(boost::hana::at(obj, key))>;
-        const auto r              = read_value_impl::apply<value_type>(std::get<1>(acc), end);
-        boost::hana::at(obj, key) = std::get<0>(r);
-        return std::make_tuple(obj, std::get<1>(r));
+        auto r                    = read_value_impl::apply<value_type>(std::get<1>(acc), end);
+        boost::hana::at(obj, key) = std::move(std::get<0>(r));
+        return std::make_tuple(std::move(obj), std::get<1>(r));
       };
     });
 
@@ -329,14 +931,14 @@ struct read_value_impl {
       if (!check_token_type(::YAML_BLOCK_ENTRY_TOKEN, begin, end)) {
         throw std::runtime_error("token type != YAML_BLOCK_ENTRY_TOKEN");
       }
-      return std::make_tuple(obj, std::next(begin));
+      return std::make_tuple(std::move(obj), std::next(begin));
     });
 
     if (!check_token_type(::YAML_BLOCK_ENTRY_TOKEN, begin, end)) {
       throw std::runtime_error("token type != YAML_BLOCK_ENTRY_TOKEN");
     }
 
-    const auto r = boost::hana::fold_left(
+    auto r = boost::hana::fold_left(
         fs2, std::forward_as_tuple(T{}, std::next(begin)),
         [end](auto&& acc, auto f) { return f(std::forward<decltype(acc)>(acc)); });
 
@@ -344,7 +946,7 @@ struct read_value_impl {
       throw std::runtime_error("token type != YAML_BLOCK_END_TOKEN");
     }
 
-    return std::make_tuple(std::get<0>(r), std::next(std::get<1>(r)));
+    return std::make_tuple(std::move(std::get<0>(r)), std::next(std::get<1>(r)));
   }
 
   template <class T, class Iterator>
@@ -353,11 +955,11 @@ struct read_value_impl {
     T result{};
     for (auto it = begin;;) {
       if (check_token_type(::YAML_BLOCK_ENTRY_TOKEN, it, end)) {
-        const auto r = read_value_impl::apply<typename T::value_type>(std::next(it), end);
-        result.emplace_back(std::get<0>(r));
+        auto r = read_value_impl::apply<typename T::value_type>(std::next(it), end);
+        result.emplace_back(std::move(std::get<0>(r)));
         it = std::get<1>(r);
       } else if (check_token_type(::YAML_BLOCK_END_TOKEN, it, end)) {
-        return std::make_tuple(result, std::next(it));
+        return std::make_tuple(std::move(result), std::next(it));
       } else {
         throw std::runtime_error("invalid token type");
       }
@@ -371,11 +973,11 @@ struct read_value_impl {
 
     const auto fs1 = boost::hana::transform(keys, [end](auto&& key) {
       return [end, key](auto acc) {
-        auto obj                  = std::get<0>(acc);
+        auto& obj                 = std::get<0>(acc);
         using value_type          = remove_cvref_t<decltype(boost::hana::at(obj, key))>;
-        const auto r              = read_value_impl::apply<value_type>(std::get<1>(acc), end);
-        boost::hana::at(obj, key) = std::get<0>(r);
-        return std::make_tuple(obj, std::get<1>(r));
+        auto r                    = read_value_impl::apply<value_type>(std::get<1>(acc), end);
+        boost::hana::at(obj, key) = std::move(std::get<0>(r));
+        return std::make_tuple(std::move(obj), std::get<1>(r));
       };
     });
 
@@ -384,10 +986,10 @@ struct read_value_impl {
       if (!check_token_type(::YAML_FLOW_ENTRY_TOKEN, begin, end)) {
         throw std::runtime_error("token type != YAML_FLOW_ENTRY_TOKEN");
       }
-      return std::make_tuple(obj, std::next(begin));
+      return std::make_tuple(std::move(obj), std::next(begin));
     });
 
-    const auto r = boost::hana::fold_left(
+    auto r = boost::hana::fold_left(
         fs2, std::forward_as_tuple(T{}, begin),
         [end](auto&& acc, auto f) { return f(std::forward<decltype(acc)>(acc)); });
 
@@ -395,7 +997,7 @@ struct read_value_impl {
       throw std::runtime_error("token type != YAML_FLOW_SEQUENCE_END_TOKEN");
     }
 
-    return std::make_tuple(std::get<0>(r), std::next(std::get<1>(r)));
+    return std::make_tuple(std::move(std::get<0>(r)), std::next(std::get<1>(r)));
   }
 
   template <class T, class Iterator>
@@ -404,15 +1006,15 @@ struct read_value_impl {
     T result{};
     for (auto it = begin;;) {
       if (check_token_type(::YAML_FLOW_SEQUENCE_END_TOKEN, it, end)) {
-        return std::make_tuple(result, std::next(it));
+        return std::make_tuple(std::move(result), std::next(it));
       }
 
       if (check_token_type(::YAML_FLOW_ENTRY_TOKEN, it, end)) {
         it = std::next(it);
       }
 
-      const auto r = read_value_impl::apply<typename T::value_type>(it, end);
-      result.emplace_back(std::get<0>(r));
+      auto r = read_value_impl::apply<typename T::value_type>(it, end);
+      result.emplace_back(std::move(std::get<0>(r)));
       it = std::get<1>(r);
     }
   }
@@ -437,16 +1039,15 @@ struct read_value_impl {
   template <class T, class Iterator, class Key>
   static auto read_struct_member(Iterator begin, Iterator end, Key key)
       -> std::enable_if_t<!is_optional<T>::value, std::tuple<T, Iterator>> {
-    const auto r =
-        read_value_impl::read_key_value<boost::hana::pair<std::string, T>>(begin, end);
+    auto r = read_value_impl::read_key_value<boost::hana::pair<std::string, T>>(begin, end);
 
-    const auto actual_key   = boost::hana::first(std::get<0>(r));
+    const auto& actual_key  = boost::hana::first(std::get<0>(r));
     constexpr auto key_cstr = boost::hana::to<const char*>(key);
     if (actual_key != key_cstr) {
       throw std::runtime_error("key does not match: ["s + actual_key + " != "s + key_cstr +
                                "]"s);
     } else {
-      return std::make_tuple(boost::hana::second(std::get<0>(r)), std::get<1>(r));
+      return std::make_tuple(std::move(boost::hana::second(std::get<0>(r))), std::get<1>(r));
     }
   }
 
@@ -457,16 +1058,17 @@ struct read_value_impl {
       throw std::runtime_error("token type != YAML_KEY_TOKEN");
     }
     using key_type = remove_cvref_t<decltype(boost::hana::first(std::declval<T>()))>;
-    const auto key = read_value_impl::apply<key_type>(std::next(begin), end);
+    auto key       = read_value_impl::apply<key_type>(std::next(begin), end);
 
     if (!check_token_type(::YAML_VALUE_TOKEN, std::get<1>(key), end)) {
       throw std::runtime_error("token type != YAML_VALUE_TOKEN");
     }
     using value_type = remove_cvref_t<decltype(boost::hana::second(std::declval<T>()))>;
-    const auto value = read_value_impl::apply<value_type>(std::next(std::get<1>(key)), end);
+    auto value       = read_value_impl::apply<value_type>(std::next(std::get<1>(key)), end);
 
-    return std::make_tuple(boost::hana::make<T>(std::get<0>(key), std::get<0>(value)),
-                           std::get<1>(value));
+    return std::make_tuple(
+        boost::hana::make<T>(std::move(std::get<0>(key)), std::move(std::get<0>(value))),
+        std::get<1>(value));
   }
 };
 
@@ -475,11 +1077,11 @@ std::tuple<T, Iterator> read_value(Iterator begin, Iterator end) {
   if (!check_token_type(::YAML_STREAM_START_TOKEN, begin, end)) {
     throw std::runtime_error("token type != YAML_STREAM_START_TOKEN");
   }
-  const auto r = read_value_impl::apply<T>(std::next(begin), end);
+  auto r = read_value_impl::apply<T>(std::next(begin), end);
   if (!check_token_type(::YAML_STREAM_END_TOKEN, std::get<1>(r), end)) {
     throw std::runtime_error("token type != YAML_BLOCK_END_TOKEN");
   }
-  return std::make_tuple(std::get<0>(r), std::next(std::get<1>(r)));
+  return std::make_tuple(std::move(std::get<0>(r)), std::next(std::get<1>(r)));
 }
 
 } // namespace yamlizer::detail
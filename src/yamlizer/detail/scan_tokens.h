@@ -0,0 +1,47 @@
+#ifndef YAMLIZER_DETAIL_SCAN_TOKENS_H
+#define YAMLIZER_DETAIL_SCAN_TOKENS_H
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "yamlizer/yaml++.h"
+
+namespace yamlizer::detail {
+
+// Thrown when libyaml rejects the input; `mark` is where it stopped.
+struct scan_error : std::runtime_error {
+  ::yaml_mark_t mark;
+
+  explicit scan_error(const parser& p)
+      : std::runtime_error{"failed to scan YAML: " + std::string{p.problem()}},
+        mark{p.problem_mark()} {}
+};
+
+// Scans the next token of `p`.
+inline token scan_token(parser& p) {
+  auto t = p.scan();
+  if (t.type() == ::YAML_NO_TOKEN) {
+    throw scan_error{p};
+  }
+  return t;
+}
+
+// Scans every token of `p` up to and including YAML_STREAM_END_TOKEN, passing each one to `f`
+// as it is stored.
+template <class F>
+std::vector<token> scan_tokens(parser& p, F&& f) {
+  std::vector<token> ts{};
+  do {
+    f(ts.emplace_back(scan_token(p)));
+  } while (ts.back().type() != ::YAML_STREAM_END_TOKEN);
+  return ts;
+}
+
+inline std::vector<token> scan_tokens(parser& p) {
+  return scan_tokens(p, [](const token&) {});
+}
+
+} // namespace yamlizer::detail
+
+#endif // YAMLIZER_DETAIL_SCAN_TOKENS_H
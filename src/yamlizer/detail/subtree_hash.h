@@ -0,0 +1,173 @@
+#ifndef YAMLIZER_DETAIL_SUBTREE_HASH_H
+#define YAMLIZER_DETAIL_SUBTREE_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+#include "yamlizer/detail/perfect_hash.h"
+#include "yamlizer/yaml++.h"
+
+namespace yamlizer::detail {
+
+// Merkle hashes of every mapping and sequence of a document, computed one token at a time while
+// it is scanned. A collection hashes its own tokens in order, with each nested collection
+// contributing only its hash, so a subtree can be compared without visiting its descendants.
+// Marks, scalar styles and the entry indicators of block and flow sequences are left out, so
+// block and flow collections of the same kind hash alike. A block sequence written without
+// indentation as a mapping value has no start and end tokens, so its entry indicators are
+// hashed instead.
+class subtree_hasher final {
+  // The hash a token contributes to its parent. For a collection start token, `end` is the index
+  // past its end token and `hash` is the hash of the whole collection.
+  struct subtree {
+    std::size_t end    = 0;
+    std::uint64_t hash = 0;
+  };
+
+  struct open_subtree {
+    std::size_t begin;
+    std::uint64_t hash;
+    bool block_sequence;
+  };
+
+  // indexed by token
+  std::vector<subtree> subtrees_;
+  std::vector<open_subtree> stack_;
+  std::uint64_t document_ = seed;
+
+  static constexpr std::uint64_t seed = 0x6a09e667f3bcc908ull;
+
+  enum class kind : std::uint64_t {
+    mapping,
+    sequence,
+    end,
+    key,
+    value,
+    scalar,
+    alias,
+    anchor,
+    tag,
+    entry,
+  };
+
+  static std::uint64_t combine(std::uint64_t h, std::uint64_t v) noexcept {
+    char bytes[sizeof v];
+    for (std::size_t i = 0; i < sizeof v; ++i) {
+      bytes[i] = static_cast<char>(v >> (i * 8));
+    }
+    return hash_string({bytes, sizeof bytes}, h);
+  }
+
+  static constexpr std::uint64_t seed_of(kind k) noexcept {
+    return static_cast<std::uint64_t>(k);
+  }
+
+  static std::string_view view(const ::yaml_char_t* s) noexcept {
+    return s ? std::string_view{reinterpret_cast<const char*>(s)} : std::string_view{};
+  }
+
+  // Hash of a token that is not a collection start or end; 0 for tokens that are left out.
+  template <class Token>
+  static std::uint64_t hash_token(const Token& t) noexcept {
+    switch (t.type()) {
+      case ::YAML_KEY_TOKEN:
+        return combine(seed, seed_of(kind::key));
+      case ::YAML_VALUE_TOKEN:
+        return combine(seed, seed_of(kind::value));
+      case ::YAML_SCALAR_TOKEN: {
+        const auto& s = t.data().scalar;
+        return hash_string({reinterpret_cast<const char*>(s.value), s.length},
+                           seed_of(kind::scalar));
+      }
+      case ::YAML_ALIAS_TOKEN:
+        return hash_string(view(t.data().alias.value), seed_of(kind::alias));
+      case ::YAML_ANCHOR_TOKEN:
+        return hash_string(view(t.data().anchor.value), seed_of(kind::anchor));
+      case ::YAML_TAG_TOKEN:
+        return combine(hash_string(view(t.data().tag.handle), seed_of(kind::tag)),
+                       hash_string(view(t.data().tag.suffix), seed_of(kind::tag)));
+      default:
+        return 0;
+    }
+  }
+
+  void add(std::size_t index, std::uint64_t v) noexcept {
+    subtrees_[index].hash = v;
+    auto& h               = stack_.empty() ? document_ : stack_.back().hash;
+    h                     = combine(h, v);
+  }
+
+public:
+  // Feeds the next token of the document.
+  template <class Token>
+  void push(const Token& t) {
+    const auto index = subtrees_.size();
+    subtrees_.emplace_back();
+
+    switch (t.type()) {
+      case ::YAML_BLOCK_MAPPING_START_TOKEN:
+      case ::YAML_FLOW_MAPPING_START_TOKEN:
+        stack_.push_back({index, combine(seed, seed_of(kind::mapping)), false});
+        break;
+
+      case ::YAML_BLOCK_SEQUENCE_START_TOKEN:
+      case ::YAML_FLOW_SEQUENCE_START_TOKEN:
+        stack_.push_back({index, combine(seed, seed_of(kind::sequence)),
+                          t.type() == ::YAML_BLOCK_SEQUENCE_START_TOKEN});
+        break;
+
+      case ::YAML_BLOCK_ENTRY_TOKEN:
+        // the only structure of a sequence without indentation
+        if (stack_.empty() || !stack_.back().block_sequence) {
+          add(index, combine(seed, seed_of(kind::entry)));
+        }
+        break;
+
+      case ::YAML_BLOCK_END_TOKEN:
+      case ::YAML_FLOW_SEQUENCE_END_TOKEN:
+      case ::YAML_FLOW_MAPPING_END_TOKEN: {
+        if (stack_.empty()) {
+          throw std::runtime_error("unbalanced collection end token");
+        }
+        const auto s = stack_.back();
+        stack_.pop_back();
+        const auto h       = combine(s.hash, seed_of(kind::end));
+        subtrees_[s.begin] = {index + 1, h};
+        add(s.begin, h);
+        break;
+      }
+
+      default:
+        if (const auto h = hash_token(t)) {
+          add(index, h);
+        }
+        break;
+    }
+  }
+
+  // Hash of the whole document.
+  std::uint64_t document() const noexcept {
+    return document_;
+  }
+
+  // Hash of the tokens in [begin, end) of the sequence fed to push(), which must not split a
+  // collection. Collections in the range are looked up rather than visited.
+  std::uint64_t hash_range(std::size_t begin, std::size_t end) const {
+    auto h = seed;
+    for (auto i = begin; i < end;) {
+      const auto& s = subtrees_.at(i);
+      if (s.hash != 0) {
+        h = combine(h, s.hash);
+      }
+      i = s.end != 0 ? s.end : i + 1;
+    }
+    return h;
+  }
+};
+
+} // namespace yamlizer::detail
+
+#endif // YAMLIZER_DETAIL_SUBTREE_HASH_H
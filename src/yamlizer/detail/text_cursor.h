@@ -0,0 +1,392 @@
+#ifndef YAMLIZER_DETAIL_TEXT_CURSOR_H
+#define YAMLIZER_DETAIL_TEXT_CURSOR_H
+
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+namespace yamlizer::detail {
+
+constexpr bool is_blank(char c) noexcept {
+  return c == ' ' || c == '\t';
+}
+
+// '\0' stands for the end of the input
+constexpr bool is_break(char c) noexcept {
+  return c == '\n' || c == '\r' || c == '\0';
+}
+
+constexpr bool is_flow_indicator(char c) noexcept {
+  return c == ',' || c == '[' || c == ']' || c == '{' || c == '}';
+}
+
+// A position in the text parsed by from_yaml_constexpr().
+class text_cursor final {
+  std::string_view s_;
+  std::size_t pos_ = 0;
+
+public:
+  constexpr explicit text_cursor(std::string_view s) noexcept : s_{s} {}
+
+  constexpr bool at_end() const noexcept {
+    return pos_ >= s_.size();
+  }
+  constexpr char peek(std::size_t n = 0) const noexcept {
+    return pos_ + n < s_.size() ? s_[pos_ + n] : '\0';
+  }
+  constexpr void advance(std::size_t n = 1) noexcept {
+    pos_ += n;
+  }
+  constexpr std::size_t position() const noexcept {
+    return pos_;
+  }
+  constexpr void seek(std::size_t pos) noexcept {
+    pos_ = pos;
+  }
+  constexpr std::string_view slice(std::size_t first, std::size_t last) const noexcept {
+    return s_.substr(first, last - first);
+  }
+
+  constexpr std::size_t column() const noexcept {
+    auto p = pos_;
+    while (p > 0 && s_[p - 1] != '\n') {
+      --p;
+    }
+    return pos_ - p;
+  }
+
+  constexpr void expect(char c) {
+    if (peek() != c) {
+      throw std::runtime_error("unexpected character");
+    }
+    advance();
+  }
+
+  // Whether a block sequence entry (`- `) starts here.
+  constexpr bool at_block_entry() const noexcept {
+    return peek() == '-' && (is_blank(peek(1)) || is_break(peek(1)));
+  }
+
+  // Skips blanks and a comment up to the end of the line.
+  constexpr void skip_blanks() noexcept {
+    while (is_blank(peek())) {
+      advance();
+    }
+    if (peek() == '#') {
+      while (!at_end() && peek() != '\n') {
+        advance();
+      }
+    }
+  }
+
+  // Skips blanks, comments and line breaks up to the next content character.
+  constexpr void skip_to_content() noexcept {
+    for (;;) {
+      skip_blanks();
+      if (peek() == '\r') {
+        advance();
+      }
+      if (at_end() || peek() != '\n') {
+        return;
+      }
+      advance();
+    }
+  }
+
+  // Ends the line of a value in block context, where only a comment may follow it.
+  constexpr void finish_line() {
+    skip_blanks();
+    if (!is_break(peek())) {
+      throw std::runtime_error("unexpected characters after a value");
+    }
+    skip_to_content();
+  }
+};
+
+// A scalar as written in the text: the characters between the quotes, or the plain scalar
+// without trailing blanks. `quote` is '\'', '"' or '\0' for plain scalars.
+struct scalar_text {
+  std::string_view raw;
+  char quote;
+};
+
+// Reads a single-line plain or quoted scalar. Plain scalars end at `: `, ` #` and the end of
+// the line, and in flow context also at flow indicators.
+constexpr scalar_text read_scalar_text(text_cursor& c, bool flow) {
+  const auto q = c.peek();
+  if (q == '\'' || q == '"') {
+    c.advance();
+    const auto first = c.position();
+    for (;;) {
+      if (c.peek() == '\n' || c.peek() == '\r' || c.at_end()) {
+        throw std::runtime_error("unterminated or multi-line quoted scalar");
+      }
+      if (q == '"' && c.peek() == '\\') {
+        c.advance(2);
+        continue;
+      }
+      if (c.peek() == q) {
+        if (q == '\'' && c.peek(1) == '\'') {
+          c.advance(2);
+          continue;
+        }
+        break;
+      }
+      c.advance();
+    }
+    const auto last = c.position();
+    c.advance();
+    return {c.slice(first, last), q};
+  }
+
+  constexpr std::string_view unsupported = "#&*!|>%@`?";
+  if (is_break(q) || is_flow_indicator(q) || unsupported.find(q) != std::string_view::npos ||
+      c.at_block_entry() || (q == ':' && (is_blank(c.peek(1)) || is_break(c.peek(1))))) {
+    throw std::runtime_error("expected a plain or quoted scalar");
+  }
+
+  const auto first = c.position();
+  auto last        = first;
+  for (;;) {
+    const auto ch = c.peek();
+    if (is_break(ch) ||
+        (ch == ':' &&
+         (is_blank(c.peek(1)) || is_break(c.peek(1)) || (flow && is_flow_indicator(c.peek(1))))) ||
+        (flow && is_flow_indicator(ch)) || (is_blank(ch) && c.peek(1) == '#')) {
+      break;
+    }
+    c.advance();
+    if (!is_blank(ch)) {
+      last = c.position();
+    }
+  }
+  c.seek(last);
+  return {c.slice(first, last), '\0'};
+}
+
+// Whether the scalar is spelled exactly as its value, so that it can be viewed in place.
+constexpr bool is_verbatim(const scalar_text& t) noexcept {
+  return t.quote == '\0' || t.raw.find(t.quote == '"' ? '\\' : '\'') == std::string_view::npos;
+}
+
+constexpr unsigned hex_value(char c) {
+  if (c >= '0' && c <= '9') {
+    return static_cast<unsigned>(c - '0');
+  } else if (c >= 'a' && c <= 'f') {
+    return static_cast<unsigned>(c - 'a' + 10);
+  } else if (c >= 'A' && c <= 'F') {
+    return static_cast<unsigned>(c - 'A' + 10);
+  }
+  throw std::runtime_error("invalid hexadecimal digit");
+}
+
+// Decodes the escape sequence after the backslash at `s[i - 1]` and returns the index of its
+// last character.
+template <class F>
+constexpr std::size_t decode_escape(std::string_view s, std::size_t i, F& put) {
+  if (i >= s.size()) {
+    throw std::runtime_error("invalid escape sequence");
+  }
+
+  std::size_t digits = 0;
+  switch (s[i]) {
+    // clang-format off
+    case '0':  put('\0');   return i;
+    case 'a':  put('\a');   return i;
+    case 'b':  put('\b');   return i;
+    case 't':
+    case '\t': put('\t');   return i;
+    case 'n':  put('\n');   return i;
+    case 'v':  put('\v');   return i;
+    case 'f':  put('\f');   return i;
+    case 'r':  put('\r');   return i;
+    case 'e':  put('\x1b'); return i;
+    case ' ':
+    case '"':
+    case '/':
+    case '\\': put(s[i]);   return i;
+    case 'x':  digits = 2;  break;
+    case 'u':  digits = 4;  break;
+    case 'U':  digits = 8;  break;
+    // clang-format on
+    default:
+      throw std::runtime_error("invalid escape sequence");
+  }
+
+  if (s.size() - i <= digits) {
+    throw std::runtime_error("invalid escape sequence");
+  }
+  char32_t cp = 0;
+  for (std::size_t n = 1; n <= digits; ++n) {
+    cp = (cp << 4) | hex_value(s[i + n]);
+  }
+  if (cp > 0x10ffff || (cp >= 0xd800 && cp <= 0xdfff)) {
+    throw std::runtime_error("invalid code point");
+  }
+
+  // encode as UTF-8
+  if (cp < 0x80) {
+    put(static_cast<char>(cp));
+  } else if (cp < 0x800) {
+    put(static_cast<char>(0xc0 | (cp >> 6)));
+    put(static_cast<char>(0x80 | (cp & 0x3f)));
+  } else if (cp < 0x10000) {
+    put(static_cast<char>(0xe0 | (cp >> 12)));
+    put(static_cast<char>(0x80 | ((cp >> 6) & 0x3f)));
+    put(static_cast<char>(0x80 | (cp & 0x3f)));
+  } else {
+    put(static_cast<char>(0xf0 | (cp >> 18)));
+    put(static_cast<char>(0x80 | ((cp >> 12) & 0x3f)));
+    put(static_cast<char>(0x80 | ((cp >> 6) & 0x3f)));
+    put(static_cast<char>(0x80 | (cp & 0x3f)));
+  }
+  return i + digits;
+}
+
+// Passes the characters of the value of `t` to `put` one at a time.
+template <class F>
+constexpr void decode_scalar_text(const scalar_text& t, F&& put) {
+  const auto s = t.raw;
+  for (std::size_t i = 0; i < s.size(); ++i) {
+    if (t.quote == '\'' && s[i] == '\'') {
+      put('\'');
+      ++i;
+    } else if (t.quote == '"' && s[i] == '\\') {
+      i = decode_escape(s, i + 1, put);
+    } else {
+      put(s[i]);
+    }
+  }
+}
+
+constexpr bool scalar_text_equals(const scalar_text& t, std::string_view s) {
+  if (is_verbatim(t)) {
+    return t.raw == s;
+  }
+  std::size_t n = 0;
+  bool equal    = true;
+  decode_scalar_text(t, [&n, &equal, s](char c) {
+    equal = equal && n < s.size() && s[n] == c;
+    ++n;
+  });
+  return equal && n == s.size();
+}
+
+// Parses a decimal integer with an optional sign, with the rules of boost::lexical_cast:
+// out-of-range values throw, except that a negative value whose magnitude fits an unsigned type
+// wraps around, e.g. "-1" is the maximum value.
+template <class T>
+constexpr T parse_integer(std::string_view s) {
+  std::size_t i = 0;
+  bool negative = false;
+  if (i < s.size() && (s[i] == '+' || s[i] == '-')) {
+    negative = s[i++] == '-';
+  }
+  if (i == s.size()) {
+    throw std::runtime_error("invalid integer");
+  }
+
+  const auto limit = static_cast<unsigned long long>(std::numeric_limits<T>::max()) +
+                     (negative && std::is_signed_v<T>);
+  unsigned long long v = 0;
+  for (; i < s.size(); ++i) {
+    if (s[i] < '0' || s[i] > '9') {
+      throw std::runtime_error("invalid integer");
+    }
+    const auto d = static_cast<unsigned long long>(s[i] - '0');
+    if (v > (limit - d) / 10) {
+      throw std::runtime_error("integer out of range");
+    }
+    v = v * 10 + d;
+  }
+  if constexpr (std::is_unsigned_v<T>) {
+    return static_cast<T>(negative ? 0ull - v : v);
+  } else {
+    return negative ? static_cast<T>(-static_cast<long long>(v - 1) - 1) : static_cast<T>(v);
+  }
+}
+
+// Parses a decimal floating-point number. The significand is kept to 19 digits and scaled by a
+// power of ten in long double, so the result may differ from strtod() in the last bit.
+template <class T>
+constexpr T parse_floating_point(std::string_view s) {
+  std::size_t i = 0;
+  bool negative = false;
+  if (i < s.size() && (s[i] == '+' || s[i] == '-')) {
+    negative = s[i++] == '-';
+  }
+
+  unsigned long long significand = 0;
+  int exponent                   = 0;
+  int digits                     = 0;
+  bool any                       = false;
+  const auto add_digit           = [&](char c, bool fraction) {
+    any = true;
+    if (digits < 19) {
+      significand = significand * 10 + static_cast<unsigned long long>(c - '0');
+      digits += significand != 0;
+      exponent -= fraction;
+    } else {
+      exponent += !fraction;
+    }
+  };
+  for (; i < s.size() && s[i] >= '0' && s[i] <= '9'; ++i) {
+    add_digit(s[i], false);
+  }
+  if (i < s.size() && s[i] == '.') {
+    for (++i; i < s.size() && s[i] >= '0' && s[i] <= '9'; ++i) {
+      add_digit(s[i], true);
+    }
+  }
+  if (!any) {
+    throw std::runtime_error("invalid floating-point number");
+  }
+
+  if (i < s.size() && (s[i] == 'e' || s[i] == 'E')) {
+    ++i;
+    bool negative_exponent = false;
+    if (i < s.size() && (s[i] == '+' || s[i] == '-')) {
+      negative_exponent = s[i++] == '-';
+    }
+    if (i == s.size()) {
+      throw std::runtime_error("invalid floating-point number");
+    }
+    int e = 0;
+    for (; i < s.size() && s[i] >= '0' && s[i] <= '9'; ++i) {
+      e = e < 100000 ? e * 10 + (s[i] - '0') : e;
+    }
+    exponent += negative_exponent ? -e : e;
+  }
+  if (i != s.size()) {
+    throw std::runtime_error("invalid floating-point number");
+  }
+
+  long double v = static_cast<long double>(significand);
+  if (v != 0 && exponent > 400) {
+    throw std::runtime_error("floating-point number out of range");
+  } else if (v != 0 && exponent < -400) {
+    v = 0;
+  } else if (v != 0 && exponent != 0) {
+    long double scale = 1;
+    long double base  = 10;
+    for (auto n = static_cast<unsigned>(exponent < 0 ? -exponent : exponent); n != 0; n >>= 1) {
+      if (n & 1) {
+        scale *= base;
+      }
+      if (n > 1) {
+        base *= base;
+      }
+    }
+    v = exponent < 0 ? v / scale : v * scale;
+  }
+  if (v > static_cast<long double>(std::numeric_limits<T>::max())) {
+    throw std::runtime_error("floating-point number out of range");
+  }
+  return static_cast<T>(negative ? -v : v);
+}
+
+} // namespace yamlizer::detail
+
+#endif // YAMLIZER_DETAIL_TEXT_CURSOR_H
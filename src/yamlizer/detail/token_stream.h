@@ -0,0 +1,124 @@
+#ifndef YAMLIZER_DETAIL_TOKEN_STREAM_H
+#define YAMLIZER_DETAIL_TOKEN_STREAM_H
+
+#include <cstddef>
+#include <deque>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include "yamlizer/detail/scan_tokens.h"
+#include "yamlizer/yaml++.h"
+
+namespace yamlizer::detail {
+
+// Tokens scanned from a parser on demand. Unlike the std::vector used by from_yaml, only the
+// tokens between the oldest unreleased position and the scan position are kept in memory.
+class token_buffer final {
+  parser& parser_;
+  std::deque<token> tokens_;
+  std::size_t offset_ = 0;
+  bool stream_end_    = false;
+
+public:
+  explicit token_buffer(parser& p) : parser_{p} {}
+
+  token_buffer(const token_buffer&) = delete;
+  token_buffer& operator=(const token_buffer&) = delete;
+
+  // Scans ahead until the token at `index` is available. Returns false if the stream ends
+  // before that.
+  bool fetch(std::size_t index) {
+    while (offset_ + tokens_.size() <= index) {
+      if (stream_end_) {
+        return false;
+      }
+      auto t      = scan_token(parser_);
+      stream_end_ = t.type() == ::YAML_STREAM_END_TOKEN;
+      tokens_.emplace_back(std::move(t));
+    }
+    return true;
+  }
+
+  const token& at(std::size_t index) {
+    if (index < offset_) {
+      throw std::logic_error("token has already been released");
+    }
+    if (!fetch(index)) {
+      throw std::runtime_error("iterator reached the end");
+    }
+    return tokens_[index - offset_];
+  }
+
+  // Drops every token before `index`.
+  void release(std::size_t index) {
+    while (offset_ < index && !tokens_.empty()) {
+      tokens_.pop_front();
+      ++offset_;
+    }
+  }
+};
+
+// Forward iterator over a token_buffer. A default-constructed iterator is the end of the
+// stream, which every other iterator compares equal to once the buffer runs out of tokens.
+class token_stream_iterator final {
+  token_buffer* buffer_ = nullptr;
+  std::size_t index_    = 0;
+
+  bool at_end() const {
+    return buffer_ == nullptr || !buffer_->fetch(index_);
+  }
+
+public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type        = token;
+  using difference_type   = std::ptrdiff_t;
+  using pointer           = const token*;
+  using reference         = const token&;
+
+  token_stream_iterator() = default;
+  token_stream_iterator(token_buffer& buffer, std::size_t index)
+      : buffer_{&buffer}, index_{index} {}
+
+  std::size_t index() const noexcept {
+    return index_;
+  }
+
+  reference operator*() const {
+    return buffer_->at(index_);
+  }
+  pointer operator->() const {
+    return &buffer_->at(index_);
+  }
+
+  token_stream_iterator& operator++() {
+    ++index_;
+    return *this;
+  }
+  token_stream_iterator operator++(int) {
+    auto it = *this;
+    ++index_;
+    return it;
+  }
+
+  friend bool operator==(const token_stream_iterator& lhs, const token_stream_iterator& rhs) {
+    if (lhs.buffer_ && rhs.buffer_) {
+      return lhs.index_ == rhs.index_;
+    }
+    return lhs.at_end() == rhs.at_end();
+  }
+  friend bool operator!=(const token_stream_iterator& lhs, const token_stream_iterator& rhs) {
+    return !(lhs == rhs);
+  }
+
+  // check_token_type() tests `begin >= end`; the end iterator is past every position.
+  friend bool operator>=(const token_stream_iterator& lhs, const token_stream_iterator& rhs) {
+    if (lhs.buffer_ && rhs.buffer_) {
+      return lhs.index_ >= rhs.index_;
+    }
+    return lhs.at_end() || rhs.buffer_ != nullptr;
+  }
+};
+
+} // namespace yamlizer::detail
+
+#endif // YAMLIZER_DETAIL_TOKEN_STREAM_H
@@ -0,0 +1,181 @@
+#ifndef YAMLIZER_DETAIL_UTF8_H
+#define YAMLIZER_DETAIL_UTF8_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace yamlizer::detail {
+
+// Decodes the multi-byte sequence starting at `p` into `cp`. Returns the number of bytes it
+// spans, or 0 if it is not valid UTF-8 (truncated, overlong, a surrogate or above U+10FFFF).
+inline std::size_t decode_utf8_sequence(const unsigned char* p, const unsigned char* end,
+                                        char32_t& cp) noexcept {
+  const auto c0 = p[0];
+
+  std::size_t length;
+  unsigned char lower = 0x80, upper = 0xbf; // valid range of the second byte
+  if (c0 >= 0xc2 && c0 <= 0xdf) {
+    length = 2;
+    cp     = c0 & 0x1f;
+  } else if (c0 >= 0xe0 && c0 <= 0xef) {
+    length = 3;
+    cp     = c0 & 0x0f;
+    lower  = c0 == 0xe0 ? 0xa0 : lower;
+    upper  = c0 == 0xed ? 0x9f : upper;
+  } else if (c0 >= 0xf0 && c0 <= 0xf4) {
+    length = 4;
+    cp     = c0 & 0x07;
+    lower  = c0 == 0xf0 ? 0x90 : lower;
+    upper  = c0 == 0xf4 ? 0x8f : upper;
+  } else {
+    return 0;
+  }
+
+  if (static_cast<std::size_t>(end - p) < length || p[1] < lower || p[1] > upper) {
+    return 0;
+  }
+  for (std::size_t i = 1; i < length; ++i) {
+    if ((p[i] & 0xc0) != 0x80) {
+      return 0;
+    }
+    cp = (cp << 6) | (p[i] & 0x3f);
+  }
+  return length;
+}
+
+// Widens the leading run of ASCII bytes of [p, end) into `dst` and returns its length.
+template <class CharT>
+std::size_t widen_ascii(const unsigned char* p, const unsigned char* end, CharT* dst) noexcept {
+  const auto begin = p;
+
+#if defined(__SSE2__)
+  const auto zero = _mm_setzero_si128();
+  for (; end - p >= 16; p += 16, dst += 16) {
+    const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    if (_mm_movemask_epi8(v) != 0) {
+      break;
+    }
+    const auto lo = _mm_unpacklo_epi8(v, zero);
+    const auto hi = _mm_unpackhi_epi8(v, zero);
+    if constexpr (sizeof(CharT) == 2) {
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), lo);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 8), hi);
+    } else {
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_unpacklo_epi16(lo, zero));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4), _mm_unpackhi_epi16(lo, zero));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 8), _mm_unpacklo_epi16(hi, zero));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 12), _mm_unpackhi_epi16(hi, zero));
+    }
+  }
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+  for (; end - p >= 16; p += 16, dst += 16) {
+    const auto v = vld1q_u8(p);
+    if (vmaxvq_u8(v) >= 0x80) {
+      break;
+    }
+    const auto lo = vmovl_u8(vget_low_u8(v));
+    const auto hi = vmovl_u8(vget_high_u8(v));
+    if constexpr (sizeof(CharT) == 2) {
+      vst1q_u16(reinterpret_cast<std::uint16_t*>(dst), lo);
+      vst1q_u16(reinterpret_cast<std::uint16_t*>(dst + 8), hi);
+    } else {
+      vst1q_u32(reinterpret_cast<std::uint32_t*>(dst), vmovl_u16(vget_low_u16(lo)));
+      vst1q_u32(reinterpret_cast<std::uint32_t*>(dst + 4), vmovl_u16(vget_high_u16(lo)));
+      vst1q_u32(reinterpret_cast<std::uint32_t*>(dst + 8), vmovl_u16(vget_low_u16(hi)));
+      vst1q_u32(reinterpret_cast<std::uint32_t*>(dst + 12), vmovl_u16(vget_high_u16(hi)));
+    }
+  }
+#else
+  for (; end - p >= 8; p += 8, dst += 8) {
+    std::uint64_t w;
+    std::memcpy(&w, p, sizeof(w));
+    if ((w & 0x8080808080808080ull) != 0) {
+      break;
+    }
+    for (std::size_t i = 0; i < 8; ++i) {
+      dst[i] = static_cast<CharT>(p[i]);
+    }
+  }
+#endif
+
+  for (; p < end && *p < 0x80; ++p, ++dst) {
+    *dst = static_cast<CharT>(*p);
+  }
+  return static_cast<std::size_t>(p - begin);
+}
+
+// Converts UTF-8 into UTF-16 (2-byte CharT) or UTF-32 (4-byte CharT), which covers wchar_t on
+// every platform. The destination is sized for the worst case of one code unit per byte and
+// written in place, then shrunk to fit. Only runs of ASCII go through widen_ascii(); multi-byte
+// sequences are decoded one at a time, without probing for ASCII between them.
+template <class CharT>
+std::basic_string<CharT> transcode_utf8(std::string_view s) {
+  static_assert(sizeof(CharT) == 2 || sizeof(CharT) == 4, "unsupported code unit size");
+
+  std::basic_string<CharT> result(s.size(), CharT{});
+  auto dst = result.data();
+
+  auto p         = reinterpret_cast<const unsigned char*>(s.data());
+  const auto end = p + s.size();
+  while (p < end) {
+    if (*p < 0x80) {
+      const auto n = widen_ascii(p, end, dst);
+      p += n;
+      dst += n;
+      continue;
+    }
+
+    char32_t cp;
+    const auto length = decode_utf8_sequence(p, end, cp);
+    if (length == 0) {
+      throw std::runtime_error("invalid UTF-8 sequence");
+    }
+    p += length;
+
+    if constexpr (sizeof(CharT) == 2) {
+      if (cp >= 0x10000) {
+        cp -= 0x10000;
+        *dst++ = static_cast<CharT>(0xd800 + (cp >> 10));
+        *dst++ = static_cast<CharT>(0xdc00 + (cp & 0x3ff));
+        continue;
+      }
+    }
+    *dst++ = static_cast<CharT>(cp);
+  }
+
+  result.resize(static_cast<std::size_t>(dst - result.data()));
+  return result;
+}
+
+inline bool is_valid_utf8(std::string_view s) noexcept {
+  auto p         = reinterpret_cast<const unsigned char*>(s.data());
+  const auto end = p + s.size();
+  while (p < end) {
+    if (*p < 0x80) {
+      ++p;
+      continue;
+    }
+    char32_t cp;
+    const auto length = decode_utf8_sequence(p, end, cp);
+    if (length == 0) {
+      return false;
+    }
+    p += length;
+  }
+  return true;
+}
+
+} // namespace yamlizer::detail
+
+#endif // YAMLIZER_DETAIL_UTF8_H
@@ -0,0 +1,412 @@
+#ifndef YAMLIZER_DETAIL_VALIDATE_VALUE_H
+#define YAMLIZER_DETAIL_VALIDATE_VALUE_H
+
+#include <cstddef>
+#include <iterator>
+#include <set>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <unordered_set>
+#include <utility>
+#include <variant>
+#include <vector>
+#include <boost/hana.hpp>
+#include <boost/type_index.hpp>
+#include "yamlizer/detail/base64.h"
+#include "yamlizer/detail/context.h"
+#include "yamlizer/detail/read_value.h"
+#include "yamlizer/detail/utf8.h"
+#include "yamlizer/yaml++.h"
+
+namespace yamlizer::detail {
+
+struct validation_failure {
+  std::string message;
+  ::yaml_mark_t mark;
+};
+
+// Whether convert_scalar<T>() would accept `s`. Arithmetic types go through the same
+// boost::convert call, so the two cannot disagree on e.g. negative unsigned values or
+// hexadecimal floats. `s` must be NUL-terminated, which libyaml guarantees for scalar tokens.
+template <class T>
+bool is_convertible_scalar(std::string_view s) {
+  if constexpr (is_wide_string<T>::value) {
+    return is_valid_utf8(s);
+  } else if constexpr (std::is_arithmetic_v<T>) {
+    boost::cnv::lexical_cast cnv{};
+    return static_cast<bool>(boost::convert<T>(s.data(), cnv));
+  } else {
+    return true;
+  }
+}
+
+// The keys of a `T` already read from a mapping, compared the way `T` compares them.
+template <class T, class = void>
+struct key_set {
+  using type =
+      std::unordered_set<typename T::key_type, typename T::hasher, typename T::key_equal>;
+};
+template <class T>
+struct key_set<T, std::enable_if_t<has_key_compare<T>::value>> {
+  using type = std::set<typename T::key_type, typename T::key_compare>;
+};
+
+// Walks the tokens with the same rules as read_value_impl but constructs no values. Each
+// function returns the iterator read_value_impl would have returned, or throws
+// validation_failure at the first token that read_value_impl would reject.
+struct validate_value_impl {
+  template <class Iterator>
+  [[noreturn]] static void fail(std::string message, Iterator it, Iterator end) {
+    const auto& t = it >= end ? *std::prev(end) : *it;
+    throw validation_failure{std::move(message), t.start_mark()};
+  }
+
+  template <class Iterator>
+  static bool check(::yaml_token_type_t type, Iterator it, Iterator end) {
+    if (it >= end) {
+      fail("iterator reached the end", it, end);
+    }
+    return it->type() == type;
+  }
+
+  template <class Iterator>
+  static Iterator expect(::yaml_token_type_t type, Iterator it, Iterator end) {
+    if (!check(type, it, end)) {
+      fail("token type != "s + std::string{token_type_to_string(type)}, it, end);
+    }
+    return std::next(it);
+  }
+
+  template <class Iterator>
+  static Iterator expect_mapping_start(Iterator it, Iterator end) {
+    if (!(check(::YAML_BLOCK_MAPPING_START_TOKEN, it, end) ||
+          check(::YAML_FLOW_MAPPING_START_TOKEN, it, end))) {
+      fail("token type != YAML_BLOCK_MAPPING_START_TOKEN || YAML_FLOW_MAPPING_START_TOKEN", it,
+           end);
+    }
+    return std::next(it);
+  }
+
+  template <class Iterator>
+  static Iterator expect_sequence_start(Iterator it, Iterator end) {
+    if (!(check(::YAML_BLOCK_SEQUENCE_START_TOKEN, it, end) ||
+          check(::YAML_FLOW_SEQUENCE_START_TOKEN, it, end))) {
+      fail("token type != YAML_BLOCK_SEQUENCE_START_TOKEN || YAML_FLOW_SEQUENCE_START_TOKEN",
+           it, end);
+    }
+    return std::next(it);
+  }
+
+  template <class T, class Iterator>
+  static auto apply(Iterator begin, Iterator end)
+      -> std::enable_if_t<std::is_arithmetic_v<T> || is_string<T>::value, Iterator> {
+    if (!check(::YAML_SCALAR_TOKEN, begin, end)) {
+      fail("token type != YAML_SCALAR_TOKEN", begin, end);
+    }
+    if constexpr (std::is_same_v<T, std::string_view>) {
+      if (!current_context().pool) {
+        fail("std::string_view requires a yamlizer::string_pool", begin, end);
+      }
+    }
+    if (!is_convertible_scalar<T>(scalar_value(*begin))) {
+      fail("failed to convert value to "s + boost::typeindex::type_id<T>().pretty_name(), begin,
+           end);
+    }
+    return std::next(begin);
+  }
+
+  template <class T, class Iterator>
+  static auto apply(Iterator begin, Iterator end)
+      -> std::enable_if_t<is_binary<T>::value || std::is_same_v<T, streamed_scalar>, Iterator> {
+    auto it     = begin;
+    bool binary = is_binary<T>::value;
+    if (check(::YAML_TAG_TOKEN, it, end)) {
+      if (!is_binary_tag(*it)) {
+        fail("unexpected tag", it, end);
+      }
+      binary = true;
+      it     = std::next(it);
+    }
+
+    if constexpr (std::is_same_v<T, std::vector<unsigned char>>) {
+      if (it == begin && (check(::YAML_BLOCK_SEQUENCE_START_TOKEN, it, end) ||
+                          check(::YAML_FLOW_SEQUENCE_START_TOKEN, it, end))) {
+        return validate_value_impl::validate_elements<T>(it, end);
+      }
+    }
+    if (!check(::YAML_SCALAR_TOKEN, it, end)) {
+      fail("token type != YAML_SCALAR_TOKEN", it, end);
+    }
+    if constexpr (std::is_same_v<T, streamed_scalar>) {
+      if (!current_context().sink) {
+        fail("yamlizer::streamed_scalar requires a yamlizer::scalar_sink", it, end);
+      }
+    }
+    if (binary) {
+      // decode into a fixed-size buffer and discard the bytes
+      try {
+        decode_base64_chunks(scalar_value(*it), [](std::string_view) {});
+      } catch (const std::runtime_error& e) {
+        fail(e.what(), it, end);
+      }
+    }
+    return std::next(it);
+  }
+
+  template <class T, class Iterator>
+  static auto apply(Iterator begin, Iterator end)
+      -> std::enable_if_t<std::is_enum_v<T>, Iterator> {
+    static_assert(has_enum_names<T>::value, "yamlizer::enum_names<T> is not specialized");
+    if (!check(::YAML_SCALAR_TOKEN, begin, end)) {
+      fail("token type != YAML_SCALAR_TOKEN", begin, end);
+    }
+    if (enum_hash<T>.find(scalar_value(*begin)) == decltype(enum_hash<T>)::npos) {
+      fail("failed to convert value to "s + boost::typeindex::type_id<T>().pretty_name(), begin,
+           end);
+    }
+    return std::next(begin);
+  }
+
+  template <class T, class Iterator>
+  static auto apply(Iterator begin, Iterator end)
+      -> std::enable_if_t<is_variant<T>::value, Iterator> {
+    std::tuple<std::size_t, Iterator, alternative_position> selected;
+    try {
+      selected = select_alternative<T>(begin, end);
+    } catch (const std::runtime_error& e) {
+      fail(e.what(), begin, end);
+    }
+    return validate_value_impl::validate_alternative<T>(
+        std::get<0>(selected), std::get<1>(selected), end, std::get<2>(selected),
+        std::make_index_sequence<std::variant_size_v<T>>{});
+  }
+
+  template <class T, class Iterator, std::size_t... Is>
+  static Iterator validate_alternative(std::size_t index, Iterator begin, Iterator end,
+                                       alternative_position position,
+                                       std::index_sequence<Is...>) {
+    using validator = Iterator (*)(Iterator, Iterator, alternative_position);
+    static constexpr validator validators[] = {
+        &validate_value_impl::validate_alternative<T, Is, Iterator>...};
+    return validators[index](begin, end, position);
+  }
+
+  template <class T, std::size_t I, class Iterator>
+  static Iterator validate_alternative(Iterator begin, Iterator end,
+                                       alternative_position position) {
+    using alternative_type = std::variant_alternative_t<I, T>;
+
+    if constexpr (shape_of<alternative_type>() == node_shape::mapping &&
+                  !boost::hana::Product<alternative_type>::value) {
+      if (position != alternative_position::node) {
+        return validate_value_impl::validate_entries<alternative_type>(
+            begin, end, position == alternative_position::block_entries);
+      }
+    } else if (position != alternative_position::node) {
+      fail("alternative selected by a discriminator must be a mapping", begin, end);
+    }
+    return validate_value_impl::apply<alternative_type>(begin, end);
+  }
+
+  template <class T, class Iterator>
+  static auto apply(Iterator begin, Iterator end)
+      -> std::enable_if_t<boost::hana::Product<T>::value, Iterator> {
+    const auto it = validate_value_impl::validate_key_value<T>(expect_mapping_start(begin, end),
+                                                               end);
+    if (!(check(::YAML_BLOCK_END_TOKEN, it, end) ||
+          check(::YAML_FLOW_MAPPING_END_TOKEN, it, end))) {
+      fail("token type != YAML_BLOCK_END_TOKEN || YAML_FLOW_MAPPING_END_TOKEN", it, end);
+    }
+    return std::next(it);
+  }
+
+  template <class T, class Iterator>
+  static auto apply(Iterator begin, Iterator end)
+      -> std::enable_if_t<is_optional<T>::value, Iterator> {
+    try {
+      return validate_value_impl::apply<typename T::value_type>(begin, end);
+    } catch (const validation_failure&) {
+      return begin;
+    }
+  }
+
+  template <class T, class Iterator>
+  static auto apply(Iterator begin, Iterator end)
+      -> std::enable_if_t<has_emplace<T>::value && is_key_value_container<T>::value, Iterator> {
+    const bool block = check(::YAML_BLOCK_MAPPING_START_TOKEN, begin, end);
+    return validate_value_impl::validate_entries<T>(expect_mapping_start(begin, end), end,
+                                                    block);
+  }
+
+  template <class T, class Iterator>
+  static auto validate_entries(Iterator begin, Iterator end, bool block)
+      -> std::enable_if_t<has_emplace<T>::value && is_key_value_container<T>::value, Iterator> {
+    using key_type  = typename T::key_type;
+    const auto last = block ? ::YAML_BLOCK_END_TOKEN : ::YAML_FLOW_MAPPING_END_TOKEN;
+
+    // Duplicates of string keys are detected on the raw key text, which needs no key objects.
+    // Other keys are converted first, since e.g. `1` and `01` are the same int.
+    std::conditional_t<is_string<key_type>::value, std::unordered_set<std::string_view>,
+                       typename key_set<T>::type>
+        keys{};
+    for (auto it = begin;;) {
+      if (check(last, it, end)) {
+        return std::next(it);
+      }
+      if (!block && check(::YAML_FLOW_ENTRY_TOKEN, it, end)) {
+        it = std::next(it);
+      }
+
+      const auto key = expect(::YAML_KEY_TOKEN, it, end);
+      it             = validate_value_impl::apply<key_type>(key, end);
+
+      bool inserted = true;
+      if constexpr (is_string<key_type>::value) {
+        inserted = key->type() != ::YAML_SCALAR_TOKEN || keys.emplace(scalar_value(*key)).second;
+      } else {
+        inserted = keys.insert(std::get<0>(read_value_impl::apply<key_type>(key, end))).second;
+      }
+      if (!inserted) {
+        fail("failed to insert an object", key, end);
+      }
+      it = validate_value_impl::apply<typename T::mapped_type>(
+          expect(::YAML_VALUE_TOKEN, it, end), end);
+    }
+  }
+
+  template <class T, class Iterator>
+  static auto apply(Iterator begin, Iterator end)
+      -> std::enable_if_t<boost::hana::Foldable<T>::value && boost::hana::Struct<T>::value,
+                          Iterator> {
+    const bool block = check(::YAML_BLOCK_MAPPING_START_TOKEN, begin, end);
+    return validate_value_impl::validate_entries<T>(expect_mapping_start(begin, end), end,
+                                                    block);
+  }
+
+  template <class T, class Iterator>
+  static auto validate_entries(Iterator begin, Iterator end, bool block)
+      -> std::enable_if_t<boost::hana::Foldable<T>::value && boost::hana::Struct<T>::value,
+                          Iterator> {
+    auto it    = begin;
+    bool first = true;
+    boost::hana::for_each(boost::hana::keys(T{}), [&it, end, block, &first](auto key) {
+      if (!block && !std::exchange(first, false)) {
+        it = expect(::YAML_FLOW_ENTRY_TOKEN, it, end);
+      }
+      using value_type = remove_cvref_t<decltype(boost::hana::at_key(std::declval<T&>(), key))>;
+      it = validate_value_impl::validate_struct_member<value_type>(it, end, key);
+    });
+
+    return expect(block ? ::YAML_BLOCK_END_TOKEN : ::YAML_FLOW_MAPPING_END_TOKEN, it, end);
+  }
+
+  template <class T, class Iterator>
+  static auto apply(Iterator begin, Iterator end)
+      -> std::enable_if_t<boost::hana::Foldable<T>::value && !boost::hana::Product<T>::value &&
+                              !boost::hana::Struct<T>::value,
+                          Iterator> {
+    const bool block = check(::YAML_BLOCK_SEQUENCE_START_TOKEN, begin, end);
+    auto it          = expect_sequence_start(begin, end);
+
+    bool first = true;
+    boost::hana::for_each(make_index_range<T>(), [&it, end, block, &first](auto key) {
+      if (block || !std::exchange(first, false)) {
+        it = expect(block ? ::YAML_BLOCK_ENTRY_TOKEN : ::YAML_FLOW_ENTRY_TOKEN, it, end);
+      }
+      using value_type = remove_cvref_t<decltype(boost::hana::at(std::declval<T&>(), key))>;
+      it               = validate_value_impl::apply<value_type>(it, end);
+    });
+    if (block && first) {
+      // read_block_sequence expects an entry even for empty tuples
+      it = expect(::YAML_BLOCK_ENTRY_TOKEN, it, end);
+    }
+
+    return expect(block ? ::YAML_BLOCK_END_TOKEN : ::YAML_FLOW_SEQUENCE_END_TOKEN, it, end);
+  }
+
+  template <class T, class Iterator>
+  static auto apply(Iterator begin, Iterator end)
+      -> std::enable_if_t<has_emplace_back<T>::value && !is_string<T>::value &&
+                              !is_binary<T>::value,
+                          Iterator> {
+    return validate_value_impl::validate_elements<T>(begin, end);
+  }
+
+  template <class T, class Iterator>
+  static Iterator validate_elements(Iterator begin, Iterator end) {
+    if (check(::YAML_BLOCK_SEQUENCE_START_TOKEN, begin, end)) {
+      for (auto it = std::next(begin);;) {
+        if (check(::YAML_BLOCK_ENTRY_TOKEN, it, end)) {
+          it = validate_value_impl::apply<typename T::value_type>(std::next(it), end);
+        } else if (check(::YAML_BLOCK_END_TOKEN, it, end)) {
+          return std::next(it);
+        } else {
+          fail("invalid token type", it, end);
+        }
+      }
+    }
+
+    for (auto it = expect_sequence_start(begin, end);;) {
+      if (check(::YAML_FLOW_SEQUENCE_END_TOKEN, it, end)) {
+        return std::next(it);
+      }
+      if (check(::YAML_FLOW_ENTRY_TOKEN, it, end)) {
+        it = std::next(it);
+      }
+      it = validate_value_impl::apply<typename T::value_type>(it, end);
+    }
+  }
+
+  template <class T, class Iterator, class Key>
+  static auto validate_struct_member(Iterator begin, Iterator end, Key key)
+      -> std::enable_if_t<is_optional<T>::value, Iterator> {
+    const auto k = expect(::YAML_KEY_TOKEN, begin, end);
+    validate_value_impl::apply<std::string>(k, end);
+
+    constexpr auto key_cstr = boost::hana::to<const char*>(key);
+    if (scalar_value(*k) != key_cstr) {
+      return begin;
+    }
+
+    return validate_value_impl::validate_struct_member<typename T::value_type>(begin, end, key);
+  }
+
+  template <class T, class Iterator, class Key>
+  static auto validate_struct_member(Iterator begin, Iterator end, Key key)
+      -> std::enable_if_t<!is_optional<T>::value, Iterator> {
+    const auto k  = expect(::YAML_KEY_TOKEN, begin, end);
+    const auto it = validate_value_impl::apply<std::string>(k, end);
+
+    constexpr auto key_cstr = boost::hana::to<const char*>(key);
+    if (const auto actual_key = scalar_value(*k); actual_key != key_cstr) {
+      fail("key does not match: ["s + std::string{actual_key} + " != "s + key_cstr + "]"s, k,
+           end);
+    }
+
+    return validate_value_impl::apply<T>(expect(::YAML_VALUE_TOKEN, it, end), end);
+  }
+
+  template <class T, class Iterator>
+  static auto validate_key_value(Iterator begin, Iterator end)
+      -> std::enable_if_t<boost::hana::Product<T>::value, Iterator> {
+    using key_type   = remove_cvref_t<decltype(boost::hana::first(std::declval<T>()))>;
+    using value_type = remove_cvref_t<decltype(boost::hana::second(std::declval<T>()))>;
+
+    const auto it = validate_value_impl::apply<key_type>(expect(::YAML_KEY_TOKEN, begin, end),
+                                                         end);
+    return validate_value_impl::apply<value_type>(expect(::YAML_VALUE_TOKEN, it, end), end);
+  }
+};
+
+template <class T, class Iterator>
+Iterator validate_value(Iterator begin, Iterator end) {
+  using impl    = validate_value_impl;
+  const auto it = impl::apply<T>(impl::expect(::YAML_STREAM_START_TOKEN, begin, end), end);
+  return impl::expect(::YAML_STREAM_END_TOKEN, it, end);
+}
+
+} // namespace yamlizer::detail
+
+#endif // YAMLIZER_DETAIL_VALIDATE_VALUE_H
@@ -0,0 +1,125 @@
+#ifndef YAMLIZER_FEEDER_H
+#define YAMLIZER_FEEDER_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+
+#include "detail/bounded_queue.h"
+#include "detail/read_value.h"
+#include "detail/token_stream.h"
+#include "for_each.h"
+#include "yaml++.h"
+
+namespace yamlizer {
+
+// Push-style counterpart of from_yaml. Chunks passed to feed() may split the document at any
+// byte; they are scanned and deserialized on a worker thread as they arrive, and finish()
+// returns the value once the end of the input has been reached.
+//
+// Each chunk is dropped once libyaml has consumed it, but the scanned tokens are a second copy
+// of its scalars. When `T` is a sequence container, they are released after each element has
+// been read. For any other `T` they are kept until finish(), since the readers may return to
+// any token they have passed, e.g. to retry an optional struct member.
+//
+//   yamlizer::feeder<book> f{};
+//   while (read(fd, buf, sizeof(buf)) > 0) f.feed(...);
+//   const auto b = f.finish();
+template <class T>
+class feeder final {
+  detail::bounded_queue<std::string> chunks_;
+  std::future<T> result_;
+  bool finished_ = false;
+
+  T run() {
+    struct close_on_exit {
+      detail::bounded_queue<std::string>& q;
+      ~close_on_exit() {
+        // unblocks feed() if deserialization stopped early
+        q.close();
+      }
+    } closer{chunks_};
+
+    std::string chunk{};
+    std::size_t offset = 0;
+    parser p{[this, &chunk, &offset](char* buffer, std::size_t size) -> std::size_t {
+      while (offset == chunk.size()) {
+        auto next = chunks_.pop();
+        if (!next) {
+          return 0;
+        }
+        chunk  = std::move(*next);
+        offset = 0;
+      }
+      const auto n = std::min(size, chunk.size() - offset);
+      std::memcpy(buffer, chunk.data() + offset, n);
+      offset += n;
+      return n;
+    }};
+
+    detail::token_buffer tokens{p};
+    if constexpr (detail::has_emplace_back<T>::value && !detail::is_string<T>::value &&
+                  !detail::is_binary<T>::value) {
+      T result{};
+      detail::for_each_element<typename T::value_type>(
+          tokens, [&result](typename T::value_type&& v) {
+            result.emplace_back(std::move(v));
+            return true;
+          });
+      return result;
+    } else {
+      auto r = detail::read_value<T>(detail::token_stream_iterator{tokens, 0},
+                                     detail::token_stream_iterator{});
+      return std::move(std::get<0>(r));
+    }
+  }
+
+public:
+  // `max_pending_chunks` bounds how many chunks feed() queues before it waits for the worker.
+  explicit feeder(std::size_t max_pending_chunks = 16)
+      : chunks_{max_pending_chunks},
+        result_{std::async(std::launch::async, [this] { return run(); })} {}
+
+  ~feeder() {
+    if (!finished_) {
+      chunks_.close();
+      result_.wait();
+    }
+  }
+
+  feeder(const feeder&) = delete;
+  feeder& operator=(const feeder&) = delete;
+
+  void feed(std::string_view chunk) {
+    if (finished_) {
+      throw std::logic_error("feed() after finish()");
+    }
+    if (chunk.empty()) {
+      return;
+    }
+    if (!chunks_.push(std::string{chunk})) {
+      // the worker has stopped; rethrow its error
+      finished_ = true;
+      result_.get();
+      throw std::runtime_error("unexpected data after the end of the document");
+    }
+  }
+
+  T finish() {
+    if (finished_) {
+      throw std::logic_error("finish() called twice");
+    }
+    finished_ = true;
+    chunks_.close();
+    return result_.get();
+  }
+};
+
+} // namespace yamlizer
+
+#endif // YAMLIZER_FEEDER_H
@@ -0,0 +1,85 @@
+#ifndef YAMLIZER_FIXED_STRING_H
+#define YAMLIZER_FIXED_STRING_H
+
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <string_view>
+
+namespace yamlizer {
+
+// A NUL-terminated string of at most `N` characters stored inline, usable in constant
+// expressions. Growing it past `N` throws.
+template <std::size_t N>
+class fixed_string final {
+  std::array<char, N + 1> data_{};
+  std::size_t size_ = 0;
+
+public:
+  constexpr fixed_string() noexcept = default;
+
+  constexpr fixed_string(std::string_view s) {
+    for (const auto c : s) {
+      push_back(c);
+    }
+  }
+
+  constexpr void push_back(char c) {
+    if (size_ == N) {
+      throw std::length_error("yamlizer::fixed_string capacity exceeded");
+    }
+    data_[size_++] = c;
+  }
+
+  constexpr const char* data() const noexcept {
+    return data_.data();
+  }
+  constexpr const char* c_str() const noexcept {
+    return data_.data();
+  }
+  constexpr std::size_t size() const noexcept {
+    return size_;
+  }
+  constexpr bool empty() const noexcept {
+    return size_ == 0;
+  }
+  static constexpr std::size_t capacity() noexcept {
+    return N;
+  }
+
+  constexpr const char* begin() const noexcept {
+    return data_.data();
+  }
+  constexpr const char* end() const noexcept {
+    return data_.data() + size_;
+  }
+
+  constexpr operator std::string_view() const noexcept {
+    return {data_.data(), size_};
+  }
+
+  friend constexpr bool operator==(const fixed_string& a, std::string_view b) noexcept {
+    return std::string_view{a} == b;
+  }
+  friend constexpr bool operator==(std::string_view a, const fixed_string& b) noexcept {
+    return a == std::string_view{b};
+  }
+  friend constexpr bool operator!=(const fixed_string& a, std::string_view b) noexcept {
+    return !(a == b);
+  }
+  friend constexpr bool operator!=(std::string_view a, const fixed_string& b) noexcept {
+    return !(a == b);
+  }
+  template <std::size_t M>
+  friend constexpr bool operator==(const fixed_string& a, const fixed_string<M>& b) noexcept {
+    return std::string_view{a} == std::string_view{b};
+  }
+  template <std::size_t M>
+  friend constexpr bool operator!=(const fixed_string& a, const fixed_string<M>& b) noexcept {
+    return !(a == b);
+  }
+};
+
+} // namespace yamlizer
+
+#endif // YAMLIZER_FIXED_STRING_H
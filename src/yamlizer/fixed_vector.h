@@ -0,0 +1,57 @@
+#ifndef YAMLIZER_FIXED_VECTOR_H
+#define YAMLIZER_FIXED_VECTOR_H
+
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+
+namespace yamlizer {
+
+// A sequence of at most `N` elements stored inline, usable in constant expressions. `T` must be
+// default-constructible; growing past `N` throws.
+template <class T, std::size_t N>
+class fixed_vector final {
+  std::array<T, N> data_{};
+  std::size_t size_ = 0;
+
+public:
+  using value_type = T;
+
+  constexpr void push_back(const T& v) {
+    if (size_ == N) {
+      throw std::length_error("yamlizer::fixed_vector capacity exceeded");
+    }
+    data_[size_++] = v;
+  }
+
+  constexpr std::size_t size() const noexcept {
+    return size_;
+  }
+  constexpr bool empty() const noexcept {
+    return size_ == 0;
+  }
+  static constexpr std::size_t capacity() noexcept {
+    return N;
+  }
+
+  constexpr const T& operator[](std::size_t i) const noexcept {
+    return data_[i];
+  }
+  constexpr const T& at(std::size_t i) const {
+    if (i >= size_) {
+      throw std::out_of_range("yamlizer::fixed_vector index out of range");
+    }
+    return data_[i];
+  }
+
+  constexpr const T* begin() const noexcept {
+    return data_.data();
+  }
+  constexpr const T* end() const noexcept {
+    return data_.data() + size_;
+  }
+};
+
+} // namespace yamlizer
+
+#endif // YAMLIZER_FIXED_VECTOR_H
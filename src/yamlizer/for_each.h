@@ -0,0 +1,119 @@
+#ifndef YAMLIZER_FOR_EACH_H
+#define YAMLIZER_FOR_EACH_H
+
+#include <cstddef>
+#include <future>
+#include <stdexcept>
+#include <string_view>
+#include <tuple>
+#include <utility>
+
+#include "detail/bounded_queue.h"
+#include "detail/read_value.h"
+#include "detail/token_stream.h"
+#include "yaml++.h"
+
+namespace yamlizer {
+
+namespace detail {
+
+// Deserializes the elements of a top-level sequence one at a time and passes them to `f`,
+// releasing the tokens of each element before the next one is scanned. Stops early when `f`
+// returns false.
+template <class T, class F>
+void for_each_element(token_buffer& tokens, F&& f) {
+  const token_stream_iterator end{};
+  token_stream_iterator it{tokens, 0};
+
+  if (!check_token_type(::YAML_STREAM_START_TOKEN, it, end)) {
+    throw std::runtime_error("token type != YAML_STREAM_START_TOKEN");
+  }
+  ++it;
+
+  const bool block = check_token_type(::YAML_BLOCK_SEQUENCE_START_TOKEN, it, end);
+  if (!block && !check_token_type(::YAML_FLOW_SEQUENCE_START_TOKEN, it, end)) {
+    throw std::runtime_error(
+        "token type != YAML_BLOCK_SEQUENCE_START_TOKEN || YAML_FLOW_SEQUENCE_START_TOKEN");
+  }
+  ++it;
+
+  for (;;) {
+    if (block) {
+      if (check_token_type(::YAML_BLOCK_END_TOKEN, it, end)) {
+        break;
+      } else if (!check_token_type(::YAML_BLOCK_ENTRY_TOKEN, it, end)) {
+        throw std::runtime_error("invalid token type");
+      }
+      ++it;
+    } else {
+      if (check_token_type(::YAML_FLOW_SEQUENCE_END_TOKEN, it, end)) {
+        break;
+      } else if (check_token_type(::YAML_FLOW_ENTRY_TOKEN, it, end)) {
+        ++it;
+      }
+    }
+
+    auto r = read_value_impl::apply<T>(it, end);
+    it     = std::get<1>(r);
+    tokens.release(it.index());
+    if (!f(std::move(std::get<0>(r)))) {
+      return;
+    }
+  }
+  ++it;
+
+  if (!check_token_type(::YAML_STREAM_END_TOKEN, it, end)) {
+    throw std::runtime_error("token type != YAML_STREAM_END_TOKEN");
+  }
+}
+
+} // namespace detail
+
+// Calls `callback` with each element of the top-level sequence in `input`, deserialized as
+// `T`. Only the element being deserialized is held in memory, so the callback is expected to
+// move it away.
+template <class T, class F>
+void for_each(std::string_view input, F&& callback) {
+  parser p{input};
+  detail::token_buffer tokens{p};
+  detail::for_each_element<T>(tokens, [&callback](T&& v) {
+    callback(std::move(v));
+    return true;
+  });
+}
+
+// Same as above, but the elements are deserialized on a worker thread and handed over through
+// a queue of at most `queue_capacity` elements, so `callback` runs on the calling thread while
+// the scanner moves ahead.
+template <class T, class F>
+void for_each(std::string_view input, F&& callback, std::size_t queue_capacity) {
+  detail::bounded_queue<T> queue{queue_capacity};
+
+  auto producer = std::async(std::launch::async, [input, &queue] {
+    struct close_on_exit {
+      detail::bounded_queue<T>& q;
+      ~close_on_exit() {
+        q.close();
+      }
+    } closer{queue};
+
+    parser p{input};
+    detail::token_buffer tokens{p};
+    detail::for_each_element<T>(tokens, [&queue](T&& v) { return queue.push(std::move(v)); });
+  });
+
+  try {
+    while (auto v = queue.pop()) {
+      callback(std::move(*v));
+    }
+  } catch (...) {
+    queue.close();
+    producer.wait();
+    throw;
+  }
+  producer.get();
+}
+
+} // namespace yamlizer
+
+#endif // YAMLIZER_FOR_EACH_H
@@ -1,10 +1,16 @@
 #ifndef YAMLIZER_FROM_YAML_H
 #define YAMLIZER_FROM_YAML_H
 
+#include <stdexcept>
+#include <string>
 #include <string_view>
 #include <vector>
 
+#include "detail/context.h"
 #include "detail/read_value.h"
+#include "detail/scan_tokens.h"
+#include "scalar_sink.h"
+#include "string_pool.h"
 #include "yaml++.h"
 
 namespace yamlizer {
@@ -13,16 +19,30 @@ template <class T>
 T from_yaml(std::string_view yaml) {
   parser p{yaml};
 
-  std::vector<token> ts{};
-  for (auto prev_token = ::YAML_NO_TOKEN; prev_token != ::YAML_STREAM_END_TOKEN;) {
-    auto t     = p.scan();
-    prev_token = t.type();
-    ts.emplace_back(std::move(t));
-  }
+  const auto ts = detail::scan_tokens(p);
 
   return std::get<0>(detail::read_value<T>(ts.cbegin(), ts.cend()));
 }
 
+// Deserializes `yaml` with every std::string_view in `T` interned into `pool`. The result
+// refers to the pool and must not outlive it.
+template <class T>
+T from_yaml(std::string_view yaml, string_pool& pool) {
+  const detail::context_scope scope{{&pool}};
+  return from_yaml<T>(yaml);
+}
+
+// Deserializes `yaml` with the bytes of every yamlizer::streamed_scalar in `T` passed to
+// `sink`, so that huge scalars are consumed without being stored.
+template <class T>
+T from_yaml(std::string_view yaml, const scalar_sink& sink) {
+  auto c     = detail::current_context();
+  c.sink     = &sink;
+  c.streamed = 0;
+  const detail::context_scope scope{c};
+  return from_yaml<T>(yaml);
+}
+
 } // namespace yamlizer
 
 #endif // YAMLIZER_FROM_YAML_H
@@ -0,0 +1,349 @@
+#ifndef YAMLIZER_FROM_YAML_CONSTEXPR_H
+#define YAMLIZER_FROM_YAML_CONSTEXPR_H
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <boost/hana.hpp>
+#include "customization.h"
+#include "detail/read_value.h"
+#include "detail/text_cursor.h"
+#include "fixed_string.h"
+#include "fixed_vector.h"
+
+namespace yamlizer {
+
+namespace detail {
+
+template <class T>
+struct is_fixed_string : std::false_type {};
+template <std::size_t N>
+struct is_fixed_string<fixed_string<N>> : std::true_type {};
+
+template <class T>
+struct is_fixed_vector : std::false_type {};
+template <class T, std::size_t N>
+struct is_fixed_vector<fixed_vector<T, N>> : std::true_type {};
+
+// Sequences with one element per type, read in order.
+template <class T>
+struct is_fixed_sequence : std::false_type {};
+template <class T, std::size_t N>
+struct is_fixed_sequence<std::array<T, N>> : std::true_type {};
+template <class... Ts>
+struct is_fixed_sequence<std::tuple<Ts...>> : std::true_type {};
+
+template <class T, std::size_t I>
+using member_key_t =
+    remove_cvref_t<decltype(boost::hana::at_c<I>(boost::hana::keys(std::declval<T>())))>;
+
+template <class T, std::size_t I>
+using member_type_t =
+    remove_cvref_t<decltype(boost::hana::at_key(std::declval<T&>(), member_key_t<T, I>{}))>;
+
+template <class T>
+constexpr std::size_t member_count_v =
+    decltype(boost::hana::length(boost::hana::keys(std::declval<T>())))::value;
+
+// Converts the value of a scalar with the same rules as convert_scalar(), e.g. only "0" and
+// "1" for bool.
+template <class T>
+constexpr T convert_scalar_text(const scalar_text& t) {
+  if constexpr (is_fixed_string<T>::value) {
+    T result{};
+    decode_scalar_text(t, [&result](char c) { result.push_back(c); });
+    return result;
+  } else if constexpr (std::is_same_v<T, std::string_view>) {
+    if (!is_verbatim(t)) {
+      throw std::runtime_error("std::string_view cannot refer to a scalar with escapes");
+    }
+    return t.raw;
+  } else if constexpr (std::is_enum_v<T>) {
+    static_assert(has_enum_names<T>::value, "yamlizer::enum_names<T> is not specialized");
+    for (const auto& e : enum_names<T>::value) {
+      if (scalar_text_equals(t, e.first)) {
+        return e.second;
+      }
+    }
+    throw std::runtime_error("unknown enumerator");
+  } else {
+    static_assert(std::is_arithmetic_v<T>, "unsupported type for from_yaml_constexpr");
+    fixed_string<64> s{};
+    decode_scalar_text(t, [&s](char c) { s.push_back(c); });
+
+    if constexpr (std::is_same_v<T, bool>) {
+      if (s != "0" && s != "1") {
+        throw std::runtime_error("invalid bool");
+      }
+      return s == "1";
+    } else if constexpr (std::is_same_v<T, char> || std::is_same_v<T, signed char> ||
+                         std::is_same_v<T, unsigned char>) {
+      if (s.size() != 1) {
+        throw std::runtime_error("invalid character");
+      }
+      return static_cast<T>(*s.begin());
+    } else if constexpr (std::is_integral_v<T>) {
+      return parse_integer<T>(s);
+    } else {
+      return parse_floating_point<T>(s);
+    }
+  }
+}
+
+// Recursive-descent counterpart of read_value_impl over the text itself. In block context a
+// node is read up to the first content character of the line after it; in flow context, up to
+// the character right after it. Structs and fixed sequences are aggregate-initialized from
+// their elements, which are evaluated in order.
+struct constexpr_reader {
+  template <class T>
+  static constexpr T read_node(text_cursor& c, bool flow) {
+    if constexpr (is_optional<T>::value) {
+      return T{read_node<typename T::value_type>(c, flow)};
+    } else if constexpr (boost::hana::Struct<T>::value) {
+      return read_struct<T>(c, flow, std::make_index_sequence<member_count_v<T>>{});
+    } else if constexpr (is_fixed_vector<T>::value || is_fixed_sequence<T>::value) {
+      return read_sequence<T>(c, flow);
+    } else {
+      const auto t = read_scalar_text(c, flow);
+      auto v       = convert_scalar_text<T>(t);
+      if (!flow) {
+        c.finish_line();
+      }
+      return v;
+    }
+  }
+
+  // Reads the value after a mapping key or a sequence entry indicator of a block collection at
+  // `column`: on the same line, or on the following, more indented lines. A sequence may also
+  // sit at `column` when it is the value of a mapping.
+  template <class T>
+  static constexpr T read_block_value(text_cursor& c, std::size_t column, bool mapping) {
+    c.skip_blanks();
+    if (!is_break(c.peek())) {
+      return read_node<T>(c, false);
+    }
+
+    c.skip_to_content();
+    if (!c.at_end() && (c.column() > column || (mapping && c.column() == column &&
+                                                c.at_block_entry()))) {
+      return read_node<T>(c, false);
+    }
+    return missing_value<T>("missing value");
+  }
+
+  // An absent node is an empty optional; for any other type it is an error.
+  template <class T>
+  static constexpr T missing_value(const char* message) {
+    if constexpr (is_optional<T>::value) {
+      return T{};
+    } else {
+      throw std::runtime_error(message);
+    }
+  }
+
+  template <class T, std::size_t... Is>
+  static constexpr T read_struct(text_cursor& c, bool flow, std::index_sequence<Is...>) {
+    if (flow || c.peek() == '{') {
+      c.expect('{');
+      T result{read_flow_member<T, Is>(c)...};
+      c.skip_to_content();
+      if (c.peek() != '}') {
+        throw std::runtime_error("unexpected key");
+      }
+      c.advance();
+      if (!flow) {
+        c.finish_line();
+      }
+      return result;
+    }
+
+    const auto column = c.column();
+    T result{read_block_member<T, Is>(c, column)...};
+    if (!c.at_end() && c.column() >= column) {
+      throw std::runtime_error(c.column() == column ? "unexpected key" : "bad indentation");
+    }
+    return result;
+  }
+
+  // Reads the key of member `I`. An optional member whose key does not come next is left
+  // empty without consuming anything, like read_struct_member().
+  template <class T, std::size_t I>
+  static constexpr bool read_member_key(text_cursor& c, bool flow) {
+    constexpr std::string_view name = boost::hana::to<const char*>(member_key_t<T, I>{});
+
+    const auto start = c.position();
+    if (!(flow ? c.peek() == '}' : c.at_end())) {
+      if (scalar_text_equals(read_scalar_text(c, flow), name)) {
+        flow ? c.skip_to_content() : c.skip_blanks();
+        c.expect(':');
+        return true;
+      }
+    }
+    c.seek(start);
+
+    missing_value<member_type_t<T, I>>("key does not match");
+    return false;
+  }
+
+  template <class T, std::size_t I>
+  static constexpr member_type_t<T, I> read_block_member(text_cursor& c, std::size_t column) {
+    if (!c.at_end() && c.column() > column) {
+      throw std::runtime_error("bad indentation");
+    }
+    if (!c.at_end() && c.column() < column) {
+      return missing_value<member_type_t<T, I>>("key does not match");
+    }
+    if (!read_member_key<T, I>(c, false)) {
+      return member_type_t<T, I>{};
+    }
+    return read_block_value<member_type_t<T, I>>(c, column, true);
+  }
+
+  template <class T, std::size_t I>
+  static constexpr member_type_t<T, I> read_flow_member(text_cursor& c) {
+    c.skip_to_content();
+    if (!read_member_key<T, I>(c, true)) {
+      return member_type_t<T, I>{};
+    }
+    c.skip_to_content();
+    auto v = read_node<member_type_t<T, I>>(c, true);
+    read_flow_separator(c, '}');
+    return v;
+  }
+
+  // Consumes the ',' after a flow collection entry, unless the collection ends with `last`.
+  static constexpr void read_flow_separator(text_cursor& c, char last) {
+    c.skip_to_content();
+    if (c.peek() == ',') {
+      c.advance();
+    } else if (c.peek() != last) {
+      throw std::runtime_error("expected ',' in a flow collection");
+    }
+  }
+
+  template <class T>
+  static constexpr T read_sequence(text_cursor& c, bool flow) {
+    if (flow || c.peek() == '[') {
+      c.expect('[');
+      auto result = read_elements<T>(c, true, 0);
+      c.skip_to_content();
+      if (c.peek() != ']') {
+        throw std::runtime_error("too many elements");
+      }
+      c.advance();
+      if (!flow) {
+        c.finish_line();
+      }
+      return result;
+    }
+
+    if (!c.at_block_entry()) {
+      throw std::runtime_error("expected a sequence");
+    }
+    const auto column = c.column();
+    auto result       = read_elements<T>(c, false, column);
+    if (!c.at_end() && c.column() >= column && (c.column() > column || c.at_block_entry())) {
+      throw std::runtime_error(c.column() == column ? "too many elements" : "bad indentation");
+    }
+    return result;
+  }
+
+  template <class T>
+  static constexpr T read_elements(text_cursor& c, bool flow, std::size_t column) {
+    if constexpr (is_fixed_vector<T>::value) {
+      T result{};
+      while (has_element(c, flow, column)) {
+        result.push_back(read_element<typename T::value_type>(c, flow, column));
+      }
+      return result;
+    } else {
+      return read_fixed_elements<T>(c, flow, column,
+                                    std::make_index_sequence<std::tuple_size_v<T>>{});
+    }
+  }
+
+  template <class T, std::size_t... Is>
+  static constexpr T read_fixed_elements(text_cursor& c, bool flow, std::size_t column,
+                                         std::index_sequence<Is...>) {
+    return T{read_required_element<std::tuple_element_t<Is, T>>(c, flow, column)...};
+  }
+
+  static constexpr bool has_element(text_cursor& c, bool flow, std::size_t column) {
+    if (flow) {
+      c.skip_to_content();
+      return c.peek() != ']';
+    }
+    return !c.at_end() && c.column() == column && c.at_block_entry();
+  }
+
+  template <class T>
+  static constexpr T read_required_element(text_cursor& c, bool flow, std::size_t column) {
+    if (!has_element(c, flow, column)) {
+      throw std::runtime_error("too few elements");
+    }
+    return read_element<T>(c, flow, column);
+  }
+
+  template <class T>
+  static constexpr T read_element(text_cursor& c, bool flow, std::size_t column) {
+    if (flow) {
+      auto v = read_node<T>(c, true);
+      read_flow_separator(c, ']');
+      return v;
+    }
+    c.advance(); // '-'
+    return read_block_value<T>(c, column, false);
+  }
+};
+
+} // namespace detail
+
+// Deserializes a subset of YAML in a constant expression:
+//
+//   constexpr auto cfg = yamlizer::from_yaml_constexpr<config>(R"(
+//   name: default
+//   limits: {cpu: 2, memory: 512}
+//   )");
+//
+// Block and flow mappings and sequences with single-line plain, single-quoted and
+// double-quoted scalars are supported; anchors, tags, block scalars and multi-line scalars are
+// not. `T` is built from arithmetic types, enums with yamlizer::enum_names,
+// yamlizer::fixed_string, std::string_view (for scalars without escapes), yamlizer::fixed_vector,
+// std::array, std::tuple, std::optional and Boost.Hana structs that are aggregates. Struct keys
+// must appear in declaration order, as with from_yaml().
+//
+// Malformed input throws, which is a compile error when the call is a constant expression.
+template <class T>
+constexpr T from_yaml_constexpr(std::string_view yaml) {
+  detail::text_cursor c{yaml};
+  c.skip_to_content();
+  if (c.column() == 0 && c.peek() == '-' && c.peek(1) == '-' && c.peek(2) == '-' &&
+      (detail::is_blank(c.peek(3)) || detail::is_break(c.peek(3)))) {
+    c.advance(3);
+    c.skip_to_content();
+  }
+  if (c.at_end()) {
+    throw std::runtime_error("empty document");
+  }
+
+  auto result = detail::constexpr_reader::read_node<T>(c, false);
+
+  if (c.column() == 0 && c.peek() == '.' && c.peek(1) == '.' && c.peek(2) == '.') {
+    c.advance(3);
+    c.skip_to_content();
+  }
+  if (!c.at_end()) {
+    throw std::runtime_error("unexpected content after the document");
+  }
+  return result;
+}
+
+} // namespace yamlizer
+
+#endif // YAMLIZER_FROM_YAML_CONSTEXPR_H
@@ -0,0 +1,34 @@
+#ifndef YAMLIZER_FROM_YAML_FILE_H
+#define YAMLIZER_FROM_YAML_FILE_H
+
+#include <filesystem>
+#include <tuple>
+#include <vector>
+
+#include "detail/file_cache.h"
+#include "detail/read_value.h"
+
+namespace yamlizer {
+
+// Deserializes the file at `path`. A node tagged `!include` is replaced by the root node of the
+// file it names, relative to the including file:
+//
+//   defaults: !include common/defaults.yaml
+//
+// Included files are loaded concurrently and scanned once into a process-wide cache, which is
+// shared by every load that references them until they change on disk. Include cycles throw.
+template <class T>
+T from_yaml_file(const std::filesystem::path& path) {
+  const auto root  = std::filesystem::canonical(path);
+  const auto files = detail::load_included_files(root);
+
+  std::vector<detail::token_ref> ts{};
+  std::vector<std::filesystem::path> stack{};
+  detail::splice_tokens(files, root, stack, ts);
+
+  return std::get<0>(detail::read_value<T>(ts.cbegin(), ts.cend()));
+}
+
+} // namespace yamlizer
+
+#endif // YAMLIZER_FROM_YAML_FILE_H
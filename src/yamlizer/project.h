@@ -0,0 +1,244 @@
+#ifndef YAMLIZER_PROJECT_H
+#define YAMLIZER_PROJECT_H
+
+#include <array>
+#include <bitset>
+#include <charconv>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <vector>
+
+#include <boost/hana.hpp>
+#include "detail/read_value.h"
+#include "detail/scan_tokens.h"
+#include "yaml++.h"
+
+namespace yamlizer {
+
+namespace detail {
+
+// Number of '.'-separated segments in `path`.
+constexpr std::size_t path_depth(std::string_view path) noexcept {
+  std::size_t depth = 1;
+  for (const auto c : path) {
+    depth += c == '.';
+  }
+  return depth;
+}
+
+// The `n`-th '.'-separated segment of `path`.
+constexpr std::string_view path_segment(std::string_view path, std::size_t n) noexcept {
+  for (; n > 0; --n) {
+    const auto dot = path.find('.');
+    path           = dot == std::string_view::npos ? std::string_view{} : path.substr(dot + 1);
+  }
+  return path.substr(0, path.find('.'));
+}
+
+// Walks the document and descends only into nodes on the way to one of `paths_`. The i-th path
+// is read into the i-th member of `T` with read_value_impl; every other subtree is skipped with
+// skip_value().
+template <class T, std::size_t N>
+class projector final {
+  using candidates = std::bitset<N>;
+
+  const std::array<std::string_view, N>& paths_;
+  T& result_;
+  candidates found_{};
+
+  template <class Iterator>
+  Iterator read_member(std::size_t index, Iterator begin, Iterator end) {
+    auto it = begin;
+    boost::hana::for_each(make_index_range<decltype(boost::hana::keys(std::declval<T>()))>(),
+                          [this, index, &it, end](auto i) {
+                            if (decltype(i)::value != index) {
+                              return;
+                            }
+                            using key_type = remove_cvref_t<decltype(
+                                boost::hana::at(boost::hana::keys(std::declval<T>()), i))>;
+                            auto& member = boost::hana::at_key(result_, key_type{});
+                            auto r =
+                                read_value_impl::apply<remove_cvref_t<decltype(member)>>(it, end);
+                            member = std::move(std::get<0>(r));
+                            it     = std::get<1>(r);
+                          });
+    return it;
+  }
+
+  // Visits the child named `name` of a node reached through `depth` matching segments. The node
+  // is read once for every path that ends at it, and visited again if other paths go through
+  // it, e.g. for duplicate paths or for both "spec" and "spec.replicas".
+  template <class Iterator>
+  Iterator visit_child(Iterator begin, Iterator end, std::size_t depth, candidates c,
+                       std::string_view name, bool mapping_value) {
+    candidates next{};
+    auto it   = begin;
+    bool read = false;
+    for (std::size_t i = 0; i < N; ++i) {
+      if (!c[i] || path_segment(paths_[i], depth) != name) {
+        continue;
+      }
+      if (path_depth(paths_[i]) == depth + 1) {
+        found_.set(i);
+        it   = read_member(i, begin, end);
+        read = true;
+      } else {
+        next.set(i);
+      }
+    }
+    if (!read || next.any()) {
+      it = visit(begin, end, depth + 1, next, mapping_value);
+    }
+    return it;
+  }
+
+  template <class Iterator>
+  Iterator visit(Iterator begin, Iterator end, std::size_t depth, candidates c,
+                 bool mapping_value) {
+    if (begin >= end) {
+      throw std::runtime_error("iterator reached the end");
+    }
+
+    const auto type = begin->type();
+    if (mapping_value && type == ::YAML_BLOCK_ENTRY_TOKEN) {
+      // a sequence as a mapping value may omit its indentation and start/end tokens
+      return visit_sequence(begin, end, depth, c, ::YAML_BLOCK_ENTRY_TOKEN, true);
+    }
+    if (c.none()) {
+      return skip_value(begin, end);
+    }
+
+    switch (type) {
+      case ::YAML_BLOCK_MAPPING_START_TOKEN:
+        return visit_mapping(std::next(begin), end, depth, c, ::YAML_BLOCK_END_TOKEN);
+      case ::YAML_FLOW_MAPPING_START_TOKEN:
+        return visit_mapping(std::next(begin), end, depth, c, ::YAML_FLOW_MAPPING_END_TOKEN);
+      case ::YAML_BLOCK_SEQUENCE_START_TOKEN:
+        return visit_sequence(std::next(begin), end, depth, c, ::YAML_BLOCK_END_TOKEN, false);
+      case ::YAML_FLOW_SEQUENCE_START_TOKEN:
+        return visit_sequence(std::next(begin), end, depth, c, ::YAML_FLOW_SEQUENCE_END_TOKEN,
+                              false);
+      default:
+        return skip_value(begin, end);
+    }
+  }
+
+  template <class Iterator>
+  Iterator visit_mapping(Iterator begin, Iterator end, std::size_t depth, candidates c,
+                         ::yaml_token_type_t last) {
+    for (auto it = begin;;) {
+      if (check_token_type(last, it, end)) {
+        return std::next(it);
+      }
+      if (check_token_type(::YAML_FLOW_ENTRY_TOKEN, it, end)) {
+        it = std::next(it);
+      }
+
+      if (!check_token_type(::YAML_KEY_TOKEN, it, end)) {
+        throw std::runtime_error("token type != YAML_KEY_TOKEN");
+      }
+      const auto key = std::next(it);
+      it             = skip_value(key, end);
+
+      if (!check_token_type(::YAML_VALUE_TOKEN, it, end)) {
+        throw std::runtime_error("token type != YAML_VALUE_TOKEN");
+      }
+      if (key->type() == ::YAML_SCALAR_TOKEN) {
+        it = visit_child(std::next(it), end, depth, c, scalar_value(*key), true);
+      } else {
+        it = visit(std::next(it), end, depth, candidates{}, true);
+      }
+    }
+  }
+
+  // Sequence elements are addressed by their decimal index, e.g. "items.0.name".
+  template <class Iterator>
+  Iterator visit_sequence(Iterator begin, Iterator end, std::size_t depth, candidates c,
+                          ::yaml_token_type_t last, bool indentless) {
+    auto it = begin;
+    for (std::size_t index = 0;; ++index) {
+      if (indentless ? !check_token_type(::YAML_BLOCK_ENTRY_TOKEN, it, end)
+                     : check_token_type(last, it, end)) {
+        return indentless ? it : std::next(it);
+      }
+      if (check_token_type(::YAML_BLOCK_ENTRY_TOKEN, it, end) ||
+          check_token_type(::YAML_FLOW_ENTRY_TOKEN, it, end)) {
+        it = std::next(it);
+      }
+
+      char buf[24];
+      const auto r = std::to_chars(std::begin(buf), std::end(buf), index);
+      const std::string_view name{buf, static_cast<std::size_t>(r.ptr - buf)};
+      it = visit_child(it, end, depth, c, name, false);
+    }
+  }
+
+public:
+  projector(const std::array<std::string_view, N>& paths, T& result)
+      : paths_{paths}, result_{result} {}
+
+  template <class Iterator>
+  Iterator apply(Iterator begin, Iterator end) {
+    if (!check_token_type(::YAML_STREAM_START_TOKEN, begin, end)) {
+      throw std::runtime_error("token type != YAML_STREAM_START_TOKEN");
+    }
+    candidates all{};
+    all.set();
+    const auto it = visit(std::next(begin), end, 0, all, false);
+    if (!check_token_type(::YAML_STREAM_END_TOKEN, it, end)) {
+      throw std::runtime_error("token type != YAML_STREAM_END_TOKEN");
+    }
+
+    boost::hana::for_each(make_index_range<decltype(boost::hana::keys(std::declval<T>()))>(),
+                          [this](auto i) {
+                            using key_type = remove_cvref_t<decltype(
+                                boost::hana::at(boost::hana::keys(std::declval<T>()), i))>;
+                            using value_type = remove_cvref_t<decltype(
+                                boost::hana::at_key(result_, key_type{}))>;
+                            if (!is_optional<value_type>::value && !found_[decltype(i)::value]) {
+                              throw std::runtime_error("path not found: "s +
+                                                       std::string{paths_[decltype(i)::value]});
+                            }
+                          });
+    return std::next(it);
+  }
+};
+
+} // namespace detail
+
+// Deserializes only the nodes addressed by `paths` into the members of `T`, in declaration
+// order. Paths are compile-time strings of '.'-separated mapping keys or sequence indices;
+// subtrees that no path goes through are skipped at the token level. Paths may repeat or be
+// prefixes of one another; such a node is converted once for each path.
+//
+//   struct summary {
+//     BOOST_HANA_DEFINE_STRUCT(summary, (std::string, name), (int, replicas));
+//   };
+//   const auto s = yamlizer::project<summary>(yaml, BOOST_HANA_STRING("metadata.name"),
+//                                             BOOST_HANA_STRING("spec.replicas"));
+template <class T, class... Paths>
+T project(std::string_view yaml, Paths...) {
+  static_assert(boost::hana::Struct<T>::value, "T must be a Boost.Hana Struct");
+  static_assert(sizeof...(Paths) == decltype(boost::hana::length(
+                                        boost::hana::keys(std::declval<T>())))::value,
+                "one path is required for each member of T");
+
+  static constexpr std::array<std::string_view, sizeof...(Paths)> paths{
+      std::string_view{boost::hana::to<const char*>(Paths{}), boost::hana::length(Paths{})}...};
+
+  parser p{yaml};
+
+  const auto ts = detail::scan_tokens(p);
+
+  T result{};
+  detail::projector<T, sizeof...(Paths)>{paths, result}.apply(ts.cbegin(), ts.cend());
+  return result;
+}
+
+} // namespace yamlizer
+
+#endif // YAMLIZER_PROJECT_H
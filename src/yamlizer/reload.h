@@ -0,0 +1,155 @@
+#ifndef YAMLIZER_RELOAD_H
+#define YAMLIZER_RELOAD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <boost/hana.hpp>
+#include "detail/read_value.h"
+#include "detail/scan_tokens.h"
+#include "detail/subtree_hash.h"
+#include "yaml++.h"
+
+namespace yamlizer {
+
+// What reload() remembers about the last document it read: the hash of the whole document and
+// of the value of each top-level member, in declaration order (std::nullopt for an absent
+// optional member). A default-constructed snapshot makes reload() read every member.
+struct snapshot {
+  std::uint64_t document = 0;
+  std::vector<std::optional<std::uint64_t>> members;
+};
+
+namespace detail {
+
+// Returns the iterator past the value of a mapping entry, including a block sequence written
+// without indentation, which has no start and end tokens.
+template <class Iterator>
+Iterator skip_mapping_value(Iterator begin, Iterator end) {
+  auto it = begin;
+  while (check_token_type(::YAML_BLOCK_ENTRY_TOKEN, it, end)) {
+    it = skip_value(std::next(it), end);
+  }
+  return it == begin ? skip_value(begin, end) : it;
+}
+
+} // namespace detail
+
+// Re-reads into `value` only the top-level members of `T` whose values in `yaml` differ from
+// the ones recorded in `s`, and returns their names. Every mapping and sequence is hashed while
+// the document is scanned, so unchanged members are skipped at the token level and a block
+// mapping that did not change at all is not walked. `s` is updated on success.
+//
+//   yamlizer::snapshot s{};
+//   config c{};
+//   yamlizer::reload(yaml, c, s);  // reads every member
+//   for (auto name : yamlizer::reload(edited_yaml, c, s)) {
+//     restart(name);
+//   }
+//
+// If reading a member throws, the members before it may already have been replaced while `s` is
+// left as it was, so a later reload() reads them again.
+template <class T>
+std::vector<std::string_view> reload(std::string_view yaml, T& value, snapshot& s) {
+  static_assert(boost::hana::Struct<T>::value, "T must be a Boost.Hana Struct");
+  using detail::check_token_type;
+
+  parser p{yaml};
+  detail::subtree_hasher hasher{};
+
+  const auto ts = detail::scan_tokens(p, [&hasher](const token& t) { hasher.push(t); });
+
+  const auto begin = ts.cbegin();
+  const auto end   = ts.cend();
+  if (!check_token_type(::YAML_STREAM_START_TOKEN, begin, end)) {
+    throw std::runtime_error("token type != YAML_STREAM_START_TOKEN");
+  }
+
+  auto it          = std::next(begin);
+  const auto flow  = check_token_type(::YAML_FLOW_MAPPING_START_TOKEN, it, end);
+  const auto close = flow ? ::YAML_FLOW_MAPPING_END_TOKEN : ::YAML_BLOCK_END_TOKEN;
+  if (!flow && !check_token_type(::YAML_BLOCK_MAPPING_START_TOKEN, it, end)) {
+    throw std::runtime_error(
+        "token type != YAML_BLOCK_MAPPING_START_TOKEN || YAML_FLOW_MAPPING_START_TOKEN");
+  }
+  ++it;
+
+  constexpr auto member_count =
+      decltype(boost::hana::length(boost::hana::keys(std::declval<T>())))::value;
+  const auto all = s.members.size() != member_count;
+  // Hashes do not tell block from flow style, and only the latter needs an entry separator for
+  // an absent member, so the members of a flow mapping are walked even if nothing changed.
+  if (!all && !flow && s.document == hasher.document()) {
+    return {};
+  }
+
+  std::vector<std::optional<std::uint64_t>> hashes(member_count);
+  std::vector<std::string_view> changed{};
+  boost::hana::for_each(
+      detail::make_index_range<decltype(boost::hana::keys(std::declval<T>()))>(), [&](auto i) {
+        using key_type   = detail::remove_cvref_t<decltype(
+            boost::hana::at(boost::hana::keys(std::declval<T>()), i))>;
+        using value_type = detail::remove_cvref_t<decltype(
+            boost::hana::at_key(value, key_type{}))>;
+        constexpr std::string_view name = boost::hana::to<const char*>(key_type{});
+        constexpr auto index            = decltype(i)::value;
+
+        // read_flow_mapping() expects an entry separator between members, even absent ones
+        if (flow && index > 0) {
+          if (!check_token_type(::YAML_FLOW_ENTRY_TOKEN, it, end)) {
+            throw std::runtime_error("token type != YAML_FLOW_ENTRY_TOKEN");
+          }
+          ++it;
+        }
+
+        // the same key matching as read_struct_member(), without converting the value
+        auto value_end = it;
+        if (check_token_type(::YAML_KEY_TOKEN, it, end) &&
+            check_token_type(::YAML_SCALAR_TOKEN, std::next(it), end) &&
+            detail::scalar_value(*std::next(it)) == name) {
+          const auto value_begin = std::next(it, 2);
+          if (!check_token_type(::YAML_VALUE_TOKEN, value_begin, end)) {
+            throw std::runtime_error("token type != YAML_VALUE_TOKEN");
+          }
+          value_end     = detail::skip_mapping_value(std::next(value_begin), end);
+          hashes[index] = hasher.hash_range(std::next(value_begin) - begin, value_end - begin);
+        } else if (!detail::is_optional<value_type>::value) {
+          throw std::runtime_error("key does not match: " + std::string{name});
+        }
+
+        if (!all && hashes[index] == s.members[index]) {
+          it = value_end;
+          return;
+        }
+        changed.push_back(name);
+        if (hashes[index]) {
+          auto r = detail::read_value_impl::read_struct_member<value_type>(it, end, key_type{});
+          boost::hana::at_key(value, key_type{}) = std::move(std::get<0>(r));
+          it                                     = std::get<1>(r);
+        } else {
+          boost::hana::at_key(value, key_type{}) = value_type{};
+        }
+      });
+
+  if (!check_token_type(close, it, end)) {
+    throw std::runtime_error(flow ? "token type != YAML_FLOW_MAPPING_END_TOKEN"
+                                  : "token type != YAML_BLOCK_END_TOKEN");
+  }
+  if (!check_token_type(::YAML_STREAM_END_TOKEN, std::next(it), end)) {
+    throw std::runtime_error("token type != YAML_STREAM_END_TOKEN");
+  }
+
+  s.document = hasher.document();
+  s.members  = std::move(hashes);
+  return changed;
+}
+
+} // namespace yamlizer
+
+#endif // YAMLIZER_RELOAD_H
@@ -0,0 +1,23 @@
+#ifndef YAMLIZER_SCALAR_SINK_H
+#define YAMLIZER_SCALAR_SINK_H
+
+#include <cstddef>
+#include <functional>
+#include <string_view>
+
+namespace yamlizer {
+
+// Receives the bytes of each streamed_scalar in one or more chunks. The chunks refer to the
+// parser's buffers and are only valid during the call.
+using scalar_sink = std::function<void(std::size_t id, std::string_view chunk)>;
+
+// Stands in for a scalar whose bytes are passed to the scalar_sink given to from_yaml() instead
+// of being stored. `!!binary` scalars are base64-decoded on the way.
+struct streamed_scalar {
+  std::size_t id   = 0; // the number of streamed scalars before this one in the document
+  std::size_t size = 0; // the number of bytes passed to the sink
+};
+
+} // namespace yamlizer
+
+#endif // YAMLIZER_SCALAR_SINK_H
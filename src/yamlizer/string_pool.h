@@ -0,0 +1,43 @@
+#ifndef YAMLIZER_STRING_POOL_H
+#define YAMLIZER_STRING_POOL_H
+
+#include <cstddef>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+
+namespace yamlizer {
+
+// Owns one copy of every distinct string passed to intern(). The returned views stay valid
+// for the lifetime of the pool, so std::string_view keys and values deserialized with a pool
+// share a single allocation per distinct string.
+class string_pool final {
+  std::deque<std::string> storage_;
+  std::unordered_set<std::string_view> index_;
+
+public:
+  string_pool() = default;
+
+  string_pool(const string_pool&) = delete;
+  string_pool& operator=(const string_pool&) = delete;
+
+  std::string_view intern(std::string_view s) {
+    if (const auto it = index_.find(s); it != index_.end()) {
+      return *it;
+    }
+    // std::deque never relocates its elements on emplace_back, so views into the stored
+    // strings (including SSO buffers) remain valid.
+    const std::string_view stored = storage_.emplace_back(s);
+    index_.emplace(stored);
+    return stored;
+  }
+
+  std::size_t size() const noexcept {
+    return storage_.size();
+  }
+};
+
+} // namespace yamlizer
+
+#endif // YAMLIZER_STRING_POOL_H
@@ -0,0 +1,61 @@
+#ifndef YAMLIZER_VALIDATE_H
+#define YAMLIZER_VALIDATE_H
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "detail/context.h"
+#include "detail/scan_tokens.h"
+#include "detail/validate_value.h"
+#include "scalar_sink.h"
+#include "string_pool.h"
+#include "yaml++.h"
+
+namespace yamlizer {
+
+struct validation_error {
+  std::string message;
+  std::size_t line;   // 1-based
+  std::size_t column; // 1-based
+};
+
+// Checks whether from_yaml<T>(yaml) would succeed, without constructing any value. Returns the
+// first error, located at the token that caused it.
+template <class T>
+std::optional<validation_error> validate(std::string_view yaml) {
+  parser p{yaml};
+
+  try {
+    const auto ts = detail::scan_tokens(p);
+    detail::validate_value<T>(ts.cbegin(), ts.cend());
+  } catch (const detail::scan_error& e) {
+    return validation_error{e.what(), e.mark.line + 1, e.mark.column + 1};
+  } catch (detail::validation_failure& e) {
+    return validation_error{std::move(e.message), e.mark.line + 1, e.mark.column + 1};
+  }
+  return std::nullopt;
+}
+
+// Checks whether from_yaml<T>(yaml, pool) would succeed. Nothing is interned into `pool`.
+template <class T>
+std::optional<validation_error> validate(std::string_view yaml, string_pool& pool) {
+  const detail::context_scope scope{{&pool}};
+  return validate<T>(yaml);
+}
+
+// Checks whether from_yaml<T>(yaml, sink) would succeed. Nothing is passed to `sink`.
+template <class T>
+std::optional<validation_error> validate(std::string_view yaml, const scalar_sink& sink) {
+  auto c = detail::current_context();
+  c.sink = &sink;
+  const detail::context_scope scope{c};
+  return validate<T>(yaml);
+}
+
+} // namespace yamlizer
+
+#endif // YAMLIZER_VALIDATE_H
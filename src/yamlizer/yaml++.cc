@@ -3,13 +3,28 @@
 
 namespace yamlizer {
 
+namespace {
+
+int read_handler_callback(void* data, unsigned char* buffer, std::size_t size,
+                          std::size_t* size_read) {
+  try {
+    const auto& handler = *static_cast<parser::read_handler*>(data);
+    *size_read          = handler(reinterpret_cast<char*>(buffer), size);
+    return 1;
+  } catch (...) {
+    return 0;
+  }
+}
+
+} // namespace
+
 token::token(::yaml_token_t t) : token_{std::move(t)} {}
 
 token::~token() {
   ::yaml_token_delete(&token_);
 }
 
-token::token(token&& t) noexcept {
+token::token(token&& t) noexcept : token_{} {
   std::swap(token_, t.token_);
 }
 
@@ -26,6 +41,10 @@ decltype(std::declval<::yaml_token_t>().data) token::data() const {
   return token_.data;
 }
 
+::yaml_mark_t token::start_mark() const {
+  return token_.start_mark;
+}
+
 parser::parser(std::string_view buffer) : buffer_(buffer) {
   if (!::yaml_parser_initialize(&parser_)) {
     throw std::runtime_error("Failed to initialize YAML parser");
@@ -34,17 +53,27 @@ parser::parser(std::string_view buffer) : buffer_(buffer) {
       &parser_, reinterpret_cast<const unsigned char*>(buffer_.data()), buffer_.length());
 }
 
+parser::parser(read_handler handler)
+    : handler_{std::make_unique<read_handler>(std::move(handler))} {
+  if (!::yaml_parser_initialize(&parser_)) {
+    throw std::runtime_error("Failed to initialize YAML parser");
+  }
+  ::yaml_parser_set_input(&parser_, read_handler_callback, handler_.get());
+}
+
 parser::~parser() {
   ::yaml_parser_delete(&parser_);
 }
 
-parser::parser(parser&& t) noexcept {
+parser::parser(parser&& t) noexcept : parser_{} {
   std::swap(buffer_, t.buffer_);
+  std::swap(handler_, t.handler_);
   std::swap(parser_, t.parser_);
 }
 
 parser& parser::operator=(parser&& t) noexcept {
   std::swap(buffer_, t.buffer_);
+  std::swap(handler_, t.handler_);
   std::swap(parser_, t.parser_);
   return *this;
 }
@@ -55,4 +84,12 @@ token parser::scan() {
   return {std::move(t)};
 }
 
+std::string_view parser::problem() const {
+  return parser_.problem ? std::string_view{parser_.problem} : std::string_view{};
+}
+
+::yaml_mark_t parser::problem_mark() const {
+  return parser_.problem_mark;
+}
+
 } // namespace yamlizer
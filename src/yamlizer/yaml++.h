@@ -1,7 +1,10 @@
 #ifndef YAMLIZER_YAMLXX_H
 #define YAMLIZER_YAMLXX_H
 
+#include <cstddef>
+#include <functional>
 #include <iterator>
+#include <memory>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -24,14 +27,23 @@ public:
 
   ::yaml_token_type_t type() const;
   decltype(std::declval<::yaml_token_t>().data) data() const;
+  ::yaml_mark_t start_mark() const;
 };
 
 class parser final {
+public:
+  // Fills `buffer` with up to `size` bytes and returns how many were written. Returning 0
+  // signals the end of the input; throwing reports a reader error to libyaml.
+  using read_handler = std::function<std::size_t(char* buffer, std::size_t size)>;
+
+private:
   std::string_view buffer_;
+  std::unique_ptr<read_handler> handler_;
   ::yaml_parser_t parser_;
 
 public:
   parser(std::string_view buffer);
+  explicit parser(read_handler handler);
   ~parser();
 
   parser(const parser&) = delete;
@@ -41,6 +53,8 @@ public:
   parser& operator=(parser&&) noexcept;
 
   token scan();
+  std::string_view problem() const;
+  ::yaml_mark_t problem_mark() const;
 };
 
 static constexpr std::string_view token_type_to_string(::yaml_token_type_t type) noexcept {
@@ -2,13 +2,33 @@
 #define BOOST_TEST_MODULE yamlizer
 
 #include <array>
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <functional>
 #include <iostream>
 #include <map>
+#include <string_view>
+#include <thread>
 #include <unordered_map>
+#include <variant>
 #include <vector>
+#include <unistd.h>
+#include <boost/container/flat_map.hpp>
 #include <boost/hana.hpp>
 #include <boost/test/unit_test.hpp>
+#include "yamlizer/customization.h"
+#include "yamlizer/feeder.h"
+#include "yamlizer/for_each.h"
 #include "yamlizer/from_yaml.h"
+#include "yamlizer/from_yaml_constexpr.h"
+#include "yamlizer/from_yaml_file.h"
+#include "yamlizer/project.h"
+#include "yamlizer/reload.h"
+#include "yamlizer/scalar_sink.h"
+#include "yamlizer/string_pool.h"
+#include "yamlizer/validate.h"
 #include "yamlizer/yaml++.h"
 
 struct book {
@@ -19,6 +39,62 @@ struct string3 {
   BOOST_HANA_DEFINE_STRUCT(string3, (std::array<std::string, 3>, strings));
 };
 
+struct attachment {
+  BOOST_HANA_DEFINE_STRUCT(attachment, (std::string, name), (yamlizer::streamed_scalar, script),
+                           (yamlizer::streamed_scalar, data));
+};
+
+enum class color { red, green, blue };
+
+template <>
+struct yamlizer::enum_names<color> {
+  static constexpr std::array<std::pair<std::string_view, color>, 3> value{{
+      {"red", color::red},
+      {"green", color::green},
+      {"blue", color::blue},
+  }};
+};
+
+struct circle {
+  BOOST_HANA_DEFINE_STRUCT(circle, (double, r));
+};
+
+struct rect {
+  BOOST_HANA_DEFINE_STRUCT(rect, (double, w), (double, h));
+};
+
+template <>
+struct yamlizer::variant_name<circle> {
+  static constexpr std::string_view value = "circle";
+};
+
+template <>
+struct yamlizer::variant_name<rect> {
+  static constexpr std::string_view value = "rect";
+};
+
+using shape = std::variant<circle, rect>;
+
+using shape_or_name = std::variant<circle, rect, std::string>;
+
+template <>
+struct yamlizer::variant_discriminator<shape_or_name> {
+  static constexpr std::string_view key = "type";
+};
+
+struct service {
+  BOOST_HANA_DEFINE_STRUCT(service, (std::string, name), (std::vector<int>, ports),
+                           (std::optional<std::map<std::string, int>>, limits), (book, owner));
+};
+
+struct server {
+  BOOST_HANA_DEFINE_STRUCT(server, (yamlizer::fixed_string<16>, host), (std::uint16_t, port),
+                           (double, timeout), (bool, verbose), (std::optional<int>, retries),
+                           (color, level),
+                           (yamlizer::fixed_vector<yamlizer::fixed_string<8>, 4>, tags),
+                           (std::array<int, 3>, version));
+};
+
 BOOST_AUTO_TEST_CASE(yamlxx) {
   yamlizer::parser p{R"EOS(
 foo: bar
@@ -70,6 +146,79 @@ BOOST_AUTO_TEST_CASE(deserialize_string) {
   BOOST_TEST(s2.compare(L"Hello, World!") == 0);
 }
 
+BOOST_AUTO_TEST_CASE(deserialize_wide_string) {
+  // long enough to go through the vectorized ASCII path on both sides of the non-ASCII text
+#define TEXT "ASCII text long enough for SIMD, \u00e9\u3042\U0001F600 and some more ASCII"
+  const auto yaml = reinterpret_cast<const char*>(u8"" TEXT);
+
+  const auto s1 = yamlizer::from_yaml<std::wstring>(yaml);
+  BOOST_TEST((s1 == L"" TEXT));
+
+  const auto s2 = yamlizer::from_yaml<std::u16string>(yaml);
+  BOOST_TEST((s2 == u"" TEXT));
+
+  const auto s3 = yamlizer::from_yaml<std::u32string>(yaml);
+  BOOST_TEST((s3 == U"" TEXT));
+  BOOST_TEST(s3.size() == 56u);
+#undef TEXT
+
+  // libyaml rejects malformed UTF-8 in the input, so the decoder is checked directly
+  BOOST_CHECK_THROW(yamlizer::detail::transcode_utf8<char32_t>("\xc0\xaf"), std::exception);
+  BOOST_CHECK_THROW(yamlizer::detail::transcode_utf8<char32_t>("\xed\xa0\x80"), std::exception);
+  BOOST_CHECK_THROW(yamlizer::detail::transcode_utf8<char16_t>("abc\xe3\x81"), std::exception);
+  BOOST_TEST(!yamlizer::detail::is_valid_utf8("\xf4\x90\x80\x80"));
+}
+
+BOOST_AUTO_TEST_CASE(deserialize_binary) {
+  const auto b1 = yamlizer::from_yaml<std::vector<unsigned char>>("!!binary SGVsbG8sIFdvcmxkIQ==");
+  BOOST_TEST((std::string{b1.begin(), b1.end()} == "Hello, World!"));
+
+  // a line break in the middle of the vectorized blocks
+  const auto b2 = yamlizer::from_yaml<std::vector<std::byte>>(R"EOS(!!binary |
+  AAECAwQFBgcICQoLDA0ODxAREhMUFRYXGBkaGxwd
+  Hh8gISIjJCUmJygpKissLS4v
+)EOS");
+  BOOST_TEST(b2.size() == 48u);
+  for (std::size_t i = 0; i < b2.size(); ++i) {
+    BOOST_TEST(std::to_integer<std::size_t>(b2.at(i)) == i);
+  }
+
+  const auto b3 = yamlizer::from_yaml<std::vector<unsigned char>>("SGk");
+  BOOST_TEST((std::string{b3.begin(), b3.end()} == "Hi"));
+
+  BOOST_CHECK_THROW(yamlizer::from_yaml<std::vector<std::byte>>("!!binary SGk@"), std::exception);
+  BOOST_CHECK_THROW(yamlizer::from_yaml<std::vector<std::byte>>("!!str SGk="), std::exception);
+  BOOST_CHECK_THROW(yamlizer::from_yaml<std::vector<unsigned char>>("!!binary QQ="),
+                    std::exception);
+  BOOST_TEST(!yamlizer::validate<std::vector<std::byte>>("!!binary SGVsbG8="));
+  BOOST_TEST(!!yamlizer::validate<std::vector<std::byte>>("!!binary SGVsbG8=="));
+  BOOST_TEST(!!yamlizer::validate<std::vector<std::byte>>("!!binary QQ="));
+}
+
+BOOST_AUTO_TEST_CASE(deserialize_streamed_scalar) {
+  std::string blob{};
+  for (int i = 0; i < 10000; ++i) {
+    blob += "YWJj"; // "abc"
+  }
+  const auto yaml = "name: tool\nscript: |\n  echo hello\n  exit 0\ndata: !!binary " + blob;
+
+  std::map<std::size_t, std::string> received{};
+  std::size_t chunks = 0;
+  const auto a       = yamlizer::from_yaml<attachment>(
+      yaml, [&received, &chunks](std::size_t id, std::string_view chunk) {
+        received[id] += chunk;
+        ++chunks;
+      });
+  BOOST_TEST(a.name == "tool");
+  BOOST_TEST(received.at(a.script.id) == "echo hello\nexit 0\n");
+  BOOST_TEST(a.script.size == received.at(a.script.id).size());
+  BOOST_TEST(a.data.size == 30000u);
+  BOOST_TEST(received.at(a.data.id).find_first_not_of("abc") == std::string::npos);
+  BOOST_TEST(chunks > 2u);
+
+  BOOST_CHECK_THROW(yamlizer::from_yaml<attachment>(yaml), std::exception);
+}
+
 BOOST_AUTO_TEST_CASE(deserialize_pair) {
   const auto p1 = yamlizer::from_yaml<std::pair<std::string, int>>("foo: 123");
   BOOST_TEST(std::get<0>(p1) == "foo");
@@ -260,6 +409,44 @@ book2: {
   BOOST_TEST(m5.at("book2").price == 590);
 }
 
+BOOST_AUTO_TEST_CASE(deserialize_ordered_key_value_container) {
+  using flat = boost::container::flat_map<std::string, int>;
+  const auto m1 = yamlizer::from_yaml<flat>("{c: 3, a: 1, b: 2}");
+  BOOST_TEST(m1.size() == 3u);
+  BOOST_TEST(m1.begin()->first == "a");
+  BOOST_TEST(m1.at("c") == 3);
+  BOOST_CHECK_THROW(yamlizer::from_yaml<flat>("{a: 1, b: 2, a: 3}"), std::exception);
+
+  using descending = std::map<int, std::string, std::greater<int>>;
+  const auto m2    = yamlizer::from_yaml<descending>("1: a\n3: c\n2: b\n");
+  BOOST_TEST(m2.size() == 3u);
+  BOOST_TEST(m2.begin()->first == 3);
+  BOOST_TEST(m2.at(1) == "a");
+  BOOST_CHECK_THROW(yamlizer::from_yaml<descending>("1: a\n1: b\n"), std::exception);
+
+  BOOST_TEST(!yamlizer::validate<flat>("{a: 1, b: 2}"));
+}
+
+BOOST_AUTO_TEST_CASE(deserialize_key_value_container_with_string_pool) {
+  using record = std::unordered_map<std::string_view, int>;
+
+  yamlizer::string_pool pool{};
+  const auto m = yamlizer::from_yaml<std::map<std::string, record>>(R"EOS(
+r1: {id: 1, size: 10}
+r2: {id: 2, size: 20}
+r3: {id: 3, size: 30}
+)EOS",
+                                                                    pool);
+  BOOST_TEST(m.size() == 3u);
+  BOOST_TEST(m.at("r2").at("id") == 2);
+  BOOST_TEST(m.at("r3").at("size") == 30);
+  BOOST_TEST(pool.size() == 2u);
+  BOOST_TEST(m.at("r1").find("id")->first.data() == m.at("r3").find("id")->first.data());
+
+  BOOST_CHECK_THROW(yamlizer::from_yaml<record>("id: 1"), std::exception);
+  BOOST_CHECK_THROW(yamlizer::from_yaml<record>("{id: 1, id: 2}", pool), std::exception);
+}
+
 BOOST_AUTO_TEST_CASE(deserialize_optional1) {
   const auto o1 = yamlizer::from_yaml<std::optional<int>>("");
   BOOST_TEST(!o1);
@@ -287,3 +474,465 @@ v2: poe
 
   BOOST_CHECK_THROW(yamlizer::from_yaml<optional_struct>("v1: fee\nv2: poe"), std::exception);
 }
+
+BOOST_AUTO_TEST_CASE(include_files) {
+  namespace fs   = std::filesystem;
+  const auto dir = fs::temp_directory_path() / ("yamlizer-test-" + std::to_string(::getpid()));
+  fs::create_directories(dir / "sub");
+  const auto write = [](const fs::path& p, std::string_view text) {
+    std::ofstream{p, std::ios::binary} << text;
+  };
+
+  write(dir / "base.yaml", "name: shared\nprice: 100\n");
+  write(dir / "sub" / "other.yaml", "!include ../base.yaml\n");
+  write(dir / "root.yaml", R"EOS(
+- !include base.yaml
+- !include sub/other.yaml
+- {name: inline, price: 1}
+)EOS");
+
+  const auto v1 = yamlizer::from_yaml_file<std::vector<book>>(dir / "root.yaml");
+  BOOST_TEST(v1.size() == 3u);
+  BOOST_TEST(v1.at(0).name == "shared");
+  BOOST_TEST(v1.at(1).price == 100);
+  BOOST_TEST(v1.at(2).name == "inline");
+
+  // files are scanned once until they change on disk
+  auto& cache       = yamlizer::detail::file_cache::instance();
+  const auto base   = fs::canonical(dir / "base.yaml");
+  const auto before = cache.load(base);
+  BOOST_TEST((cache.load(base) == before));
+
+  write(base, "name: shared\nprice: 200\n");
+  fs::last_write_time(base, fs::last_write_time(base) + std::chrono::hours{1});
+  const auto v2 = yamlizer::from_yaml_file<std::vector<book>>(dir / "root.yaml");
+  BOOST_TEST(v2.at(0).price == 200);
+  const auto changed = cache.load(base);
+  BOOST_TEST((changed != before));
+
+  // a new modification time with the same contents keeps the scanned tokens
+  fs::last_write_time(base, fs::last_write_time(base) + std::chrono::hours{1});
+  BOOST_TEST((cache.load(base) == changed));
+
+  write(dir / "a.yaml", "!include b.yaml\n");
+  write(dir / "b.yaml", "[!include a.yaml]\n");
+  BOOST_CHECK_THROW(yamlizer::from_yaml_file<std::vector<book>>(dir / "a.yaml"),
+                    std::exception);
+  BOOST_CHECK_THROW(yamlizer::from_yaml_file<book>(dir / "missing.yaml"), std::exception);
+
+  fs::remove_all(dir);
+}
+
+BOOST_AUTO_TEST_CASE(scan_error) {
+  BOOST_CHECK_THROW(yamlizer::from_yaml<std::string>("\"unterminated"), std::exception);
+}
+
+BOOST_AUTO_TEST_CASE(feeder_from_pipe) {
+  constexpr std::string_view yaml = R"EOS(
+book1:
+  name: Gochumon wa Usagi Desuka ? Vol.1
+  price: 819
+book2: {name: 'Anne Happy Vol.1', price: 590}
+)EOS";
+
+  int fds[2];
+  BOOST_REQUIRE(::pipe(fds) == 0);
+  std::thread writer{[fd = fds[1], yaml] {
+    for (std::size_t i = 0; i < yaml.size(); i += 5) {
+      const auto chunk = yaml.substr(i, 5);
+      static_cast<void>(::write(fd, chunk.data(), chunk.size()));
+    }
+    ::close(fd);
+  }};
+
+  yamlizer::feeder<std::map<std::string, book>> f{2};
+  char buf[7];
+  for (::ssize_t n; (n = ::read(fds[0], buf, sizeof(buf))) > 0;) {
+    f.feed({buf, static_cast<std::size_t>(n)});
+  }
+  ::close(fds[0]);
+  writer.join();
+
+  const auto m = f.finish();
+  BOOST_TEST(m.size() == 2u);
+  BOOST_TEST(m.at("book1").name == "Gochumon wa Usagi Desuka ? Vol.1");
+  BOOST_TEST(m.at("book2").price == 590);
+}
+
+BOOST_AUTO_TEST_CASE(feeder_sequence) {
+  yamlizer::feeder<std::vector<book>> f1{};
+  f1.feed("- name: foo\n  price: 1\n- {name: b");
+  f1.feed("ar, price: 2}\n");
+  const auto v1 = f1.finish();
+  BOOST_TEST(v1.size() == 2u);
+  BOOST_TEST(v1.at(1).name == "bar");
+
+  yamlizer::feeder<std::vector<int>> f2{};
+  f2.feed("[1, 2");
+  f2.feed(", 3]");
+  BOOST_TEST((f2.finish() == std::vector<int>{1, 2, 3}));
+
+  yamlizer::feeder<std::vector<int>> f3{};
+  f3.feed("[1, 2] extra");
+  BOOST_CHECK_THROW(f3.finish(), std::exception);
+}
+
+BOOST_AUTO_TEST_CASE(feeder_error) {
+  yamlizer::feeder<book> f1{};
+  f1.feed("name: foo\n");
+  f1.feed("price: bar\n");
+  BOOST_CHECK_THROW(f1.finish(), std::exception);
+
+  yamlizer::feeder<std::vector<int>> f2{1};
+  BOOST_CHECK_THROW(
+      {
+        for (int i = 0; i < 1000; ++i) f2.feed("- foo\n");
+        f2.finish();
+      },
+      std::exception);
+
+  yamlizer::feeder<int> f3{};
+  f3.feed("12");
+}
+
+BOOST_AUTO_TEST_CASE(for_each_sequence_element) {
+  constexpr auto yaml = R"EOS(
+- name: Gochumon wa Usagi Desuka ? Vol.1
+  price: 819
+- name: Anne Happy Vol.1
+  price: 590
+)EOS";
+
+  std::vector<book> v1{};
+  yamlizer::for_each<book>(yaml, [&v1](book&& b) { v1.emplace_back(std::move(b)); });
+  BOOST_TEST(v1.size() == 2u);
+  BOOST_TEST(v1.at(0).name == "Gochumon wa Usagi Desuka ? Vol.1");
+  BOOST_TEST(v1.at(1).price == 590);
+
+  std::vector<int> v2{};
+  yamlizer::for_each<int>("[1, 2, 3]", [&v2](int i) { v2.push_back(i); });
+  BOOST_TEST(v2 == (std::vector<int>{1, 2, 3}));
+
+  BOOST_CHECK_THROW(yamlizer::for_each<int>("foo: 1", [](int) {}), std::exception);
+  BOOST_CHECK_THROW(yamlizer::for_each<int>("[1, foo]", [](int) {}), std::exception);
+}
+
+BOOST_AUTO_TEST_CASE(for_each_sequence_element_with_queue) {
+  std::string yaml{};
+  for (int i = 0; i < 1000; ++i) {
+    yaml += "- " + std::to_string(i) + "\n";
+  }
+
+  long sum = 0;
+  yamlizer::for_each<int>(yaml, [&sum](int i) { sum += i; }, 4);
+  BOOST_TEST(sum == 499500);
+
+  BOOST_CHECK_THROW(yamlizer::for_each<int>(yaml + "- foo\n", [](int) {}, 4), std::exception);
+  BOOST_CHECK_THROW(yamlizer::for_each<int>(
+                        yaml, [](int i) { if (i == 10) throw std::runtime_error{"stop"}; }, 4),
+                    std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(validate_only) {
+  using msi  = std::map<std::string, int>;
+  using msvi = std::map<std::string, std::vector<int>>;
+  using mii  = std::map<int, int>;
+  using umii = std::unordered_map<int, int>;
+
+  BOOST_TEST(!yamlizer::validate<book>("name: foo\nprice: 819"));
+  BOOST_TEST(!yamlizer::validate<book>("{name: foo, price: 819}"));
+  BOOST_TEST(!yamlizer::validate<string3>("strings: [foo, bar, baz]"));
+  BOOST_TEST(!yamlizer::validate<msvi>("a: [1, 2]\nb:\n  - 3"));
+  BOOST_TEST(!yamlizer::validate<std::optional<int>>(""));
+
+  const auto e1 = yamlizer::validate<book>("name: foo\nprice: bar\n");
+  BOOST_REQUIRE(e1);
+  BOOST_TEST(e1->line == 2u);
+  BOOST_TEST(e1->column == 8u);
+
+  const auto e2 = yamlizer::validate<book>("name: foo\ncost: 819\n");
+  BOOST_REQUIRE(e2);
+  BOOST_TEST(e2->message == "key does not match: [cost != price]");
+  BOOST_TEST(e2->line == 2u);
+
+  const auto e3 = yamlizer::validate<std::array<int, 3>>("[1, 2]");
+  BOOST_REQUIRE(e3);
+  BOOST_TEST(e3->column == 6u);
+
+  BOOST_TEST(!!yamlizer::validate<short>("70000"));
+  BOOST_TEST(!!yamlizer::validate<float>("1.2.3"));
+  BOOST_TEST(!!yamlizer::validate<double>("0x10"));
+  BOOST_CHECK_THROW(yamlizer::from_yaml<double>("0x10"), std::exception);
+  // the same rules as from_yaml, which wraps negative values around for unsigned targets
+  BOOST_TEST(!yamlizer::validate<unsigned>("-1"));
+  BOOST_TEST(yamlizer::from_yaml<unsigned>("-1") == 4294967295u);
+  BOOST_TEST(!!yamlizer::validate<msi>("foo: 1\nfoo: 2"));
+  // non-string keys are compared after conversion
+  BOOST_TEST(!!yamlizer::validate<mii>("{1: 1, 01: 2}"));
+  BOOST_CHECK_THROW(yamlizer::from_yaml<mii>("{1: 1, 01: 2}"), std::exception);
+  BOOST_TEST(!!yamlizer::validate<umii>("{1: 1, 01: 2}"));
+  BOOST_TEST(!yamlizer::validate<mii>("{1: 1, 2: 2}"));
+
+  // the same context requirements as from_yaml
+  yamlizer::string_pool pool{};
+  BOOST_TEST(!!yamlizer::validate<std::string_view>("abc"));
+  BOOST_TEST(!yamlizer::validate<std::string_view>("abc", pool));
+  BOOST_TEST(pool.size() == 0u);
+  BOOST_TEST(!!yamlizer::validate<attachment>("name: a\nscript: b\ndata: !!binary YWJj"));
+  BOOST_TEST(!yamlizer::validate<attachment>("name: a\nscript: b\ndata: !!binary YWJj",
+                                             [](std::size_t, std::string_view) {}));
+  BOOST_TEST(!!yamlizer::validate<std::string>("\"unterminated"));
+}
+
+BOOST_AUTO_TEST_CASE(project_paths) {
+  struct summary {
+    BOOST_HANA_DEFINE_STRUCT(summary, (std::string, name), (int, replicas),
+                             (std::optional<std::string>, image), (std::string, port));
+  };
+
+  constexpr auto yaml = R"EOS(
+metadata:
+  name: web
+  labels: {app: web, tier: "frontend"}
+spec:
+  replicas: 3
+  template:
+    containers:
+    - name: nginx
+      image: nginx:1.25
+      ports: [80, 443]
+    - name: sidecar
+      ports: [8080]
+unused: [!!binary AAAA, {a: [1, {b: c}]}, &x foo, *x]
+)EOS";
+
+  const auto s1 = yamlizer::project<summary>(
+      yaml, BOOST_HANA_STRING("metadata.name"), BOOST_HANA_STRING("spec.replicas"),
+      BOOST_HANA_STRING("spec.template.containers.0.image"),
+      BOOST_HANA_STRING("spec.template.containers.1.ports.0"));
+  BOOST_TEST(s1.name == "web");
+  BOOST_TEST(s1.replicas == 3);
+  BOOST_TEST(s1.image.value() == "nginx:1.25");
+  BOOST_TEST(s1.port == "8080");
+
+  const auto s2 = yamlizer::project<summary>(
+      yaml, BOOST_HANA_STRING("metadata.labels.tier"), BOOST_HANA_STRING("spec.replicas"),
+      BOOST_HANA_STRING("spec.template.containers.1.image"),
+      BOOST_HANA_STRING("spec.template.containers.0.name"));
+  BOOST_TEST(s2.name == "frontend");
+  BOOST_TEST(!s2.image);
+  BOOST_TEST(s2.port == "nginx");
+
+  BOOST_CHECK_THROW(yamlizer::project<summary>(
+                        yaml, BOOST_HANA_STRING("metadata.name"),
+                        BOOST_HANA_STRING("spec.replicas"), BOOST_HANA_STRING("spec.image"),
+                        BOOST_HANA_STRING("spec.port")),
+                    std::exception);
+  BOOST_CHECK_THROW(yamlizer::project<summary>(
+                        yaml, BOOST_HANA_STRING("metadata.name"),
+                        BOOST_HANA_STRING("metadata.name"), BOOST_HANA_STRING("spec.image"),
+                        BOOST_HANA_STRING("spec.replicas")),
+                    std::exception);
+}
+
+BOOST_AUTO_TEST_CASE(project_overlapping_paths) {
+  struct labels {
+    BOOST_HANA_DEFINE_STRUCT(labels, (std::string, name), (std::string, same_name),
+                             (std::map<std::string, int>, labels), (int, tier));
+  };
+
+  const auto l = yamlizer::project<labels>(
+      "metadata: {name: web, labels: {app: 1, tier: 2}}", BOOST_HANA_STRING("metadata.name"),
+      BOOST_HANA_STRING("metadata.name"), BOOST_HANA_STRING("metadata.labels"),
+      BOOST_HANA_STRING("metadata.labels.tier"));
+  BOOST_TEST(l.name == "web");
+  BOOST_TEST(l.same_name == "web");
+  BOOST_TEST(l.labels.size() == 2u);
+  BOOST_TEST(l.tier == 2);
+}
+
+BOOST_AUTO_TEST_CASE(deserialize_enum) {
+  BOOST_TEST((yamlizer::from_yaml<color>("green") == color::green));
+
+  const auto v = yamlizer::from_yaml<std::vector<color>>("[blue, red]");
+  BOOST_TEST((v == std::vector<color>{color::blue, color::red}));
+
+  BOOST_CHECK_THROW(yamlizer::from_yaml<color>("yellow"), std::exception);
+  BOOST_CHECK_THROW(yamlizer::from_yaml<color>("Red"), std::exception);
+  BOOST_TEST(!yamlizer::validate<color>("blue"));
+  BOOST_TEST(!!yamlizer::validate<color>("purple"));
+}
+
+BOOST_AUTO_TEST_CASE(deserialize_variant_by_tag) {
+  const auto v = yamlizer::from_yaml<std::vector<shape>>(R"EOS(
+- !circle {r: 1.5}
+- !rect
+  w: 2
+  h: 3
+)EOS");
+  BOOST_TEST(v.size() == 2u);
+  BOOST_TEST(std::get<circle>(v.at(0)).r == 1.5);
+  BOOST_TEST(std::get<rect>(v.at(1)).h == 3.0);
+
+  BOOST_CHECK_THROW(yamlizer::from_yaml<shape>("!square {a: 1}"), std::exception);
+  BOOST_CHECK_THROW(yamlizer::from_yaml<shape>("{r: 1}"), std::exception);
+  BOOST_TEST(!yamlizer::validate<std::vector<shape>>("[!circle {r: 1}, !rect {w: 1, h: 2}]"));
+  BOOST_TEST(!!yamlizer::validate<shape>("!rect {r: 1}"));
+}
+
+BOOST_AUTO_TEST_CASE(deserialize_variant_by_discriminator) {
+  const auto v = yamlizer::from_yaml<std::vector<shape_or_name>>(R"EOS(
+- type: rect
+  w: 2
+  h: 3
+- {type: circle, r: 1.5}
+- unit
+)EOS");
+  BOOST_TEST(v.size() == 3u);
+  BOOST_TEST(std::get<rect>(v.at(0)).w == 2.0);
+  BOOST_TEST(std::get<circle>(v.at(1)).r == 1.5);
+  BOOST_TEST(std::get<std::string>(v.at(2)) == "unit");
+
+  BOOST_CHECK_THROW(yamlizer::from_yaml<shape_or_name>("{r: 1.5, type: circle}"),
+                    std::exception);
+  BOOST_CHECK_THROW(yamlizer::from_yaml<shape_or_name>("{type: square}"), std::exception);
+  BOOST_TEST(!yamlizer::validate<shape_or_name>("{type: circle, r: 1}"));
+  BOOST_TEST(!!yamlizer::validate<shape_or_name>("{type: circle, w: 1}"));
+}
+
+BOOST_AUTO_TEST_CASE(deserialize_variant_by_shape) {
+  using value = std::variant<int, std::vector<int>, std::map<std::string, int>>;
+  const auto v = yamlizer::from_yaml<std::vector<value>>("[1, [2, 3], {a: 4}]");
+  BOOST_TEST(std::get<int>(v.at(0)) == 1);
+  BOOST_TEST(std::get<std::vector<int>>(v.at(1)).size() == 2u);
+  BOOST_TEST(std::get<2>(v.at(2)).at("a") == 4);
+
+  using ambiguous = std::variant<int, std::string>;
+  BOOST_CHECK_THROW(yamlizer::from_yaml<ambiguous>("1"), std::exception);
+}
+
+BOOST_AUTO_TEST_CASE(deserialize_at_compile_time) {
+  constexpr auto s = yamlizer::from_yaml_constexpr<server>(R"EOS(
+host: "local\x68ost" # comment
+port: 8080
+timeout: 2.5
+verbose: 1
+level: blue
+tags:
+  - web
+  - 'it''s'
+version: [1, 2, 3]
+)EOS");
+  static_assert(s.host == "localhost");
+  static_assert(s.port == 8080);
+  static_assert(!s.retries);
+  static_assert(s.level == color::blue);
+  static_assert(s.tags.size() == 2 && s.tags[1] == "it's");
+  static_assert(s.version[2] == 3);
+  BOOST_TEST(s.timeout == 2.5);
+  BOOST_TEST(s.verbose);
+
+  constexpr std::string_view yaml = "- {r: 1.5}\n- r: 0.125\n";
+  constexpr auto c1               = yamlizer::from_yaml_constexpr<std::array<circle, 2>>(yaml);
+  const auto c2                   = yamlizer::from_yaml<std::array<circle, 2>>(yaml);
+  BOOST_TEST(c1[0].r == c2[0].r);
+  BOOST_TEST(c1[1].r == c2[1].r);
+
+  constexpr auto t = yamlizer::from_yaml_constexpr<std::tuple<int, std::optional<int>, char>>(
+      "[-12, 3, x]");
+  static_assert(std::get<0>(t) == -12 && std::get<1>(t) == 3 && std::get<2>(t) == 'x');
+
+  // negative values wrap around for unsigned targets, as with from_yaml
+  static_assert(yamlizer::from_yaml_constexpr<unsigned>("-1") == 4294967295u);
+  static_assert(yamlizer::from_yaml_constexpr<std::uint16_t>("-65535") == 1u);
+  BOOST_TEST(yamlizer::from_yaml_constexpr<unsigned>("-1") == yamlizer::from_yaml<unsigned>("-1"));
+  BOOST_CHECK_THROW(yamlizer::from_yaml_constexpr<std::uint16_t>("-65536"), std::exception);
+  BOOST_CHECK_THROW(yamlizer::from_yaml_constexpr<std::int16_t>("-32769"), std::exception);
+
+  BOOST_CHECK_THROW(yamlizer::from_yaml_constexpr<circle>("r: 1\nw: 2"), std::exception);
+  BOOST_CHECK_THROW(yamlizer::from_yaml_constexpr<std::uint8_t>("256"), std::exception);
+  BOOST_CHECK_THROW((yamlizer::from_yaml_constexpr<std::array<int, 2>>("[1]")), std::exception);
+  BOOST_CHECK_THROW((yamlizer::from_yaml_constexpr<yamlizer::fixed_vector<int, 1>>("[1, 2]")),
+                    std::exception);
+  BOOST_CHECK_THROW(yamlizer::from_yaml_constexpr<bool>("true"), std::exception);
+}
+
+BOOST_AUTO_TEST_CASE(reload_changed_members) {
+  using names = std::vector<std::string_view>;
+
+  yamlizer::snapshot snap{};
+  service s{};
+  auto changed = yamlizer::reload(R"EOS(
+name: web
+ports: [80, 443]
+owner: {name: ops, price: 0}
+)EOS",
+                                  s, snap);
+  BOOST_TEST((changed == names{"name", "ports", "limits", "owner"}));
+  BOOST_TEST(s.name == "web");
+  BOOST_TEST(s.ports.size() == 2u);
+  BOOST_TEST(!s.limits);
+
+  // unchanged members are skipped rather than read again
+  s.name  = "modified";
+  changed = yamlizer::reload(R"EOS(
+name: web
+ports:
+  - 80
+  - 8443
+owner:
+  name: ops # same structure in block style
+  price: 0
+)EOS",
+                             s, snap);
+  BOOST_TEST((changed == names{"ports"}));
+  BOOST_TEST(s.name == "modified");
+  BOOST_TEST(s.ports.at(1) == 8443);
+
+  changed = yamlizer::reload("{name: web, ports: [80, 8443], limits: {cpu: 2}, owner: "
+                             "{name: ops, price: 0}}",
+                             s, snap);
+  BOOST_TEST((changed == names{"limits"}));
+  BOOST_TEST(s.limits->at("cpu") == 2);
+
+  changed = yamlizer::reload("{name: web, ports: [80, 8443], limits: {cpu: 2}, owner: "
+                             "{name: ops, price: 0}}",
+                             s, snap);
+  BOOST_TEST(changed.empty());
+
+  const auto previous = snap.members;
+  BOOST_CHECK_THROW(yamlizer::reload("{name: web, owner: {name: ops, price: 0}}", s, snap),
+                    std::exception);
+  BOOST_TEST((snap.members == previous));
+
+  changed = yamlizer::reload("name: web\nports: [80, 8443]\nowner: {name: dev, price: 0}", s,
+                             snap);
+  BOOST_TEST((changed == names{"limits", "owner"}));
+  BOOST_TEST(!s.limits);
+  BOOST_TEST(s.owner.name == "dev");
+
+  // the same separator rules as from_yaml, which expects one for an absent member too
+  constexpr auto flow = "{name: web, ports: [80, 8443], owner: {name: dev, price: 0}}";
+  BOOST_CHECK_THROW(yamlizer::from_yaml<service>(flow), std::exception);
+  BOOST_CHECK_THROW(yamlizer::reload(flow, s, snap), std::exception);
+  yamlizer::snapshot fresh{};
+  BOOST_CHECK_THROW(yamlizer::reload(flow, s, fresh), std::exception);
+}
+
+BOOST_AUTO_TEST_CASE(reload_indentless_sequence) {
+  yamlizer::snapshot snap{};
+  book b{};
+  yamlizer::reload("name: x\nprice: 1", b, snap);
+  const auto previous = snap.members;
+
+  // a scalar replaced by a sequence without indentation is a change, which from_yaml rejects
+  BOOST_CHECK_THROW(yamlizer::reload("name:\n- x\nprice: 1", b, snap), std::exception);
+  BOOST_TEST((snap.members == previous));
+  BOOST_TEST(b.name == "x");
+
+  service s{};
+  yamlizer::reload("name: web\nports: [80, 443]\nowner: {name: ops, price: 0}", s, snap);
+  BOOST_CHECK_THROW(
+      yamlizer::reload("name: web\nports:\n- [80, 443]\nowner: {name: ops, price: 0}", s, snap),
+      std::exception);
+}